@@ -0,0 +1,51 @@
+#ifndef __PYENGINE_2_0_AFFINE_MATRIX_3X4_H__
+#define __PYENGINE_2_0_AFFINE_MATRIX_3X4_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Math/Vector3.h"
+
+// Sibling/Children includes
+
+namespace PE {
+namespace Components {
+
+// First three rows of an affine Matrix4x4 (the last row is always 0 0 0 1), in the same
+// layout as Matrix4x4::m16[0..11] and the W[0..3] per-instance packing. 48 instead of 64 bytes per joint
+struct AffineMatrix3x4
+{
+	AffineMatrix3x4() {}
+	explicit AffineMatrix3x4(const Matrix4x4 &src) { memcpy(m, src.m, sizeof(m)); }
+
+	void toMatrix4x4(Matrix4x4 &dst) const
+	{
+		memcpy(dst.m, m, sizeof(m));
+		dst.m[3][0] = dst.m[3][1] = dst.m[3][2] = 0.0f;
+		dst.m[3][3] = 1.0f;
+	}
+
+	Vector3 getPos() const { return Vector3(m[0][3], m[1][3], m[2][3]); }
+
+	Vector3 transform(const Vector3 &p) const
+	{
+		return Vector3(
+			m[0][0] * p.m_x + m[0][1] * p.m_y + m[0][2] * p.m_z + m[0][3],
+			m[1][0] * p.m_x + m[1][1] * p.m_y + m[1][2] * p.m_z + m[1][3],
+			m[2][0] * p.m_x + m[2][1] * p.m_y + m[2][2] * p.m_z + m[2][3]);
+	}
+
+	PrimitiveTypes::Float32 m[3][4];
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
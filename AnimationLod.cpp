@@ -0,0 +1,169 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "AnimationLod.h"
+#include "PaletteOps.h"
+
+namespace PE {
+namespace Components {
+
+AnimationLodSettings::AnimationLodSettings()
+: m_fullRateDistance(15.0f)
+, m_reducedRateDistance(40.0f)
+, m_midInterval(2)
+, m_farInterval(4)
+, m_culledGraceFrames(2)
+, m_bindPoseWhenCulled(false)
+, m_enabled(true)
+{
+}
+
+AnimationLodState::AnimationLodState(PE::GameContext &context, PE::MemoryArena arena)
+: m_visible(true)
+, m_distance(0.0f)
+, m_reportFrame(0)
+, m_interval(1)
+, m_phase(0)
+, m_framesSinceEval(0)
+, m_framesCulled(0)
+, m_inBindPose(false)
+, m_hasTargetPose(false)
+, m_action(EVALUATE)
+, m_fromPalette(context, arena)
+, m_toPalette(context, arena)
+{
+	// spread skeletons created together over different frames
+	static int s_nextPhase = 0;
+	m_phase = s_nextPhase++;
+}
+
+AnimationLodSettings &AnimationLod::Settings()
+{
+	static AnimationLodSettings s_settings;
+	return s_settings;
+}
+
+void AnimationLod::reportVisibility(AnimationLodState &state, bool visible, PrimitiveTypes::Float32 distance, PrimitiveTypes::UInt32 frameIndex)
+{
+	// several meshes of one skeleton report the same frame; any visible one keeps it visible
+	if (state.m_reportFrame == frameIndex)
+	{
+		state.m_visible = state.m_visible || visible;
+		if (distance < state.m_distance)
+			state.m_distance = distance;
+		return;
+	}
+	state.m_visible = visible;
+	state.m_distance = distance;
+	state.m_reportFrame = frameIndex;
+}
+
+AnimationLodState::Action AnimationLod::beginUpdate(AnimationLodState &state, PrimitiveTypes::UInt32 frameIndex, int numJoints)
+{
+	const AnimationLodSettings &settings = Settings();
+
+	// no report for the last frame (culling off, not drawn yet): treat as near and visible
+	const bool haveReport = state.m_reportFrame + 1 >= frameIndex;
+	const bool visible = !haveReport || state.m_visible;
+	const PrimitiveTypes::Float32 distance = haveReport ? state.m_distance : 0.0f;
+	const bool wasFrozen = state.m_action == AnimationLodState::FREEZE || state.m_action == AnimationLodState::BIND_POSE;
+
+	state.m_framesCulled = visible ? 0 : state.m_framesCulled + 1;
+
+	if (!settings.m_enabled)
+	{
+		state.m_interval = 1;
+		state.m_inBindPose = false;
+		return state.m_action = AnimationLodState::EVALUATE;
+	}
+
+	if (state.m_framesCulled > settings.m_culledGraceFrames)
+	{
+		if (settings.m_bindPoseWhenCulled && !state.m_inBindPose)
+		{
+			state.m_inBindPose = true;
+			return state.m_action = AnimationLodState::BIND_POSE;
+		}
+		return state.m_action = AnimationLodState::FREEZE;
+	}
+
+	int interval = 1;
+	if (distance >= settings.m_reducedRateDistance)
+		interval = settings.m_farInterval;
+	else if (distance >= settings.m_fullRateDistance)
+		interval = settings.m_midInterval;
+	if (interval < 1)
+		interval = 1;
+
+	// coming back from a frozen/bind pose or switching tiers re-evaluates immediately and does not
+	// blend from the old target
+	const bool restart = wasFrozen || interval != state.m_interval;
+	state.m_interval = interval;
+	state.m_inBindPose = false;
+
+	if (interval > 1 && state.m_toPalette.m_size != numJoints)
+	{
+		state.m_fromPalette.reset(numJoints);
+		state.m_toPalette.reset(numJoints);
+		state.m_fromPalette.m_size = state.m_toPalette.m_size = numJoints;
+	}
+	if (restart)
+		state.m_hasTargetPose = false;
+
+	++state.m_framesSinceEval;
+	const bool due = interval == 1 || restart
+		|| state.m_framesSinceEval > interval
+		|| ((frameIndex + state.m_phase) % interval) == 0;
+
+	if (due)
+	{
+		state.m_framesSinceEval = 0;
+		return state.m_action = AnimationLodState::EVALUATE;
+	}
+	return state.m_action = AnimationLodState::INTERPOLATE;
+}
+
+void AnimationLod::lerpPalette(const AffineMatrix3x4 *pFrom, const AffineMatrix3x4 *pTo, PrimitiveTypes::Float32 t, Matrix4x4 *pOut, int numJoints)
+{
+	// element-wise; poses a few frames apart are close enough that this needs no re-orthonormalization
+	PaletteOps::lerp(pFrom, pTo, t, pOut, numJoints);
+}
+
+void AnimationLod::storeEvaluatedPose(AnimationLodState &state, Matrix4x4 *pModelSpacePalette, int numJoints)
+{
+	if (state.m_toPalette.m_size != numJoints)
+		return;
+
+	if (state.m_interval <= 1 || !state.m_hasTargetPose)
+	{
+		// nothing to blend from: show the new pose and start the next interval from it
+		PaletteOps::pack(pModelSpacePalette, state.m_fromPalette.getFirstPtr(), numJoints);
+		memcpy(state.m_toPalette.getFirstPtr(), state.m_fromPalette.getFirstPtr(), sizeof(AffineMatrix3x4) * numJoints);
+		state.m_hasTargetPose = true;
+		return;
+	}
+
+	// poses are shown one interval late: the last target is shown now and the new pose is reached
+	// by the next evaluation, so motion stays continuous
+	memcpy(state.m_fromPalette.getFirstPtr(), state.m_toPalette.getFirstPtr(), sizeof(AffineMatrix3x4) * numJoints);
+	PaletteOps::pack(pModelSpacePalette, state.m_toPalette.getFirstPtr(), numJoints);
+	PaletteOps::unpack(state.m_fromPalette.getFirstPtr(), pModelSpacePalette, numJoints);
+}
+
+void AnimationLod::interpolatePose(AnimationLodState &state, Matrix4x4 *pModelSpacePalette, int numJoints)
+{
+	if (state.m_toPalette.m_size != numJoints)
+		return;
+
+	const PrimitiveTypes::Float32 t = (PrimitiveTypes::Float32)(state.m_framesSinceEval) / (PrimitiveTypes::Float32)(state.m_interval);
+	lerpPalette(state.m_fromPalette.getFirstPtr(), state.m_toPalette.getFirstPtr(), t > 1.0f ? 1.0f : t, pModelSpacePalette, numJoints);
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,88 @@
+#ifndef __PYENGINE_2_0_ANIMATION_LOD_H__
+#define __PYENGINE_2_0_ANIMATION_LOD_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+
+// Sibling/Children includes
+#include "AffineMatrix3x4.h"
+
+namespace PE {
+namespace Components {
+
+// Distance/visibility thresholds for skeleton animation updates
+struct AnimationLodSettings
+{
+	AnimationLodSettings();
+
+	PrimitiveTypes::Float32 m_fullRateDistance;    // closer than this: evaluated every frame
+	PrimitiveTypes::Float32 m_reducedRateDistance; // closer than this: every m_midInterval frames, else every m_farInterval
+	int m_midInterval;
+	int m_farInterval;
+	int m_culledGraceFrames;   // frames a skeleton keeps animating after it left every view
+	bool m_bindPoseWhenCulled; // culled skeletons switch to bind pose instead of keeping their last pose
+	bool m_enabled;
+};
+
+// Per skeleton instance state. Visibility and distance come from the culling pass of the previous frame.
+struct AnimationLodState
+{
+	enum Action
+	{
+		EVALUATE,    // sample and blend the clips
+		INTERPOLATE, // blend between the last two evaluated poses
+		BIND_POSE,   // switch to bind pose once
+		FREEZE       // keep the current palette
+	};
+
+	AnimationLodState(PE::GameContext &context, PE::MemoryArena arena);
+
+	// from culling; missing reports keep the skeleton at full rate
+	bool m_visible;
+	PrimitiveTypes::Float32 m_distance;
+	PrimitiveTypes::UInt32 m_reportFrame;
+
+	int m_interval;        // current evaluation interval in frames
+	int m_phase;           // stagger so skeletons with the same interval evaluate on different frames
+	int m_framesSinceEval;
+	int m_framesCulled;
+	bool m_inBindPose;
+	bool m_hasTargetPose;  // m_toPalette holds an evaluated pose
+	Action m_action;       // decided for this frame
+
+	// model space poses for INTERPOLATE, only allocated for skeletons that used a reduced rate
+	Array<AffineMatrix3x4> m_fromPalette;
+	Array<AffineMatrix3x4> m_toPalette;
+};
+
+struct AnimationLod
+{
+	static AnimationLodSettings &Settings();
+
+	// Called by the culling pass for the main view
+	static void reportVisibility(AnimationLodState &state, bool visible, PrimitiveTypes::Float32 distance, PrimitiveTypes::UInt32 frameIndex);
+
+	// Decides state.m_action for this frame (serial, may allocate the interpolation palettes)
+	static AnimationLodState::Action beginUpdate(AnimationLodState &state, PrimitiveTypes::UInt32 frameIndex, int numJoints);
+
+	// After EVALUATE: keeps the new pose as interpolation target and writes the pose shown this frame
+	static void storeEvaluatedPose(AnimationLodState &state, Matrix4x4 *pModelSpacePalette, int numJoints);
+
+	// INTERPOLATE: writes the in-between pose for this frame
+	static void interpolatePose(AnimationLodState &state, Matrix4x4 *pModelSpacePalette, int numJoints);
+
+	static void lerpPalette(const AffineMatrix3x4 *pFrom, const AffineMatrix3x4 *pTo, PrimitiveTypes::Float32 t, Matrix4x4 *pOut, int numJoints);
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
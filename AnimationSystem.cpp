@@ -0,0 +1,83 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "AnimationSystem.h"
+#include "JobPool.h"
+#include "PaletteOps.h"
+
+namespace PE {
+namespace Components {
+
+AnimationSystem *AnimationSystem::Instance()
+{
+	static AnimationSystem s_system;
+	return &s_system;
+}
+
+AnimationSystem::AnimationSystem()
+: m_numPending(0)
+, m_numEvaluatedLastFlush(0)
+, m_frameIndex(0)
+{
+	JobPool::Instance()->start();
+}
+
+void AnimationSystem::enqueue(Component *pAnimSM, EvaluateFunction evaluate, PostStepFunction postStep)
+{
+	if (m_numPending == PE_ANIMATION_SYSTEM_MAX_PENDING)
+	{
+		// queue is full; evaluate what we have so far and keep going
+		flush();
+	}
+
+	Entry &e = m_pending[m_numPending++];
+	e.m_pAnimSM = pAnimSM;
+	e.m_evaluate = evaluate;
+	e.m_postStep = postStep;
+}
+
+void AnimationSystem::evaluateRange(void *pUserData, int begin, int end)
+{
+	AnimationSystem *pSystem = (AnimationSystem *)(pUserData);
+	for (int i = begin; i < end; ++i)
+	{
+		if (pSystem->m_pending[i].m_evaluate)
+			pSystem->m_pending[i].m_evaluate(pSystem->m_pending[i].m_pAnimSM);
+	}
+}
+
+void AnimationSystem::flush()
+{
+	const int numPending = m_numPending;
+	if (numPending == 0)
+		return;
+
+	// the palette ops are checked once against the Matrix4x4 path before any job uses them
+	static bool s_checkedPaletteOps = false;
+	if (g_validateFastPalette && !s_checkedPaletteOps)
+	{
+		s_checkedPaletteOps = true;
+		if (!PaletteOps::selfCheck())
+			PEASSERT(false, "PaletteOps do not match the Matrix4x4 path");
+	}
+
+	JobPool::Instance()->parallelFor(numPending, PE_ANIMATION_SYSTEM_GRAIN_SIZE, &AnimationSystem::evaluateRange, this);
+
+	for (int i = 0; i < numPending; ++i)
+	{
+		if (m_pending[i].m_postStep)
+			m_pending[i].m_postStep(m_pending[i].m_pAnimSM);
+	}
+
+	m_numPending = 0;
+	m_numEvaluatedLastFlush = numPending;
+	++m_frameIndex;
+}
+
+}; // namespace Components
+}; // namespace PE
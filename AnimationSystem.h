@@ -0,0 +1,62 @@
+#ifndef __PYENGINE_2_0_ANIMATION_SYSTEM_H__
+#define __PYENGINE_2_0_ANIMATION_SYSTEM_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+
+// Sibling/Children includes
+
+#define PE_ANIMATION_SYSTEM_MAX_PENDING 1024
+#define PE_ANIMATION_SYSTEM_GRAIN_SIZE 4 // skeletons per job chunk
+
+namespace PE {
+namespace Components {
+
+struct Component;
+
+// Frame phase for skeleton palettes. Animation state machines queue themselves during
+// Event_CALCULATE_TRANSFORMATIONS; flush() evaluates every queued palette on the job pool and then
+// runs the post steps (physics, anything touching other objects) serially, in queue order.
+// Palettes are only valid after flush(); readers call it first, later calls in the frame do nothing.
+struct AnimationSystem
+{
+	typedef void (*EvaluateFunction)(Component *pAnimSM); // must only touch the state machine's own data; may be NULL
+	typedef void (*PostStepFunction)(Component *pAnimSM);
+
+	static AnimationSystem *Instance();
+
+	void enqueue(Component *pAnimSM, EvaluateFunction evaluate, PostStepFunction postStep);
+	void flush();
+
+	int getNumEvaluatedLastFlush() const { return m_numEvaluatedLastFlush; }
+
+	// Advances with every flush that evaluated something, i.e. once per frame with animated skeletons
+	PrimitiveTypes::UInt32 getFrameIndex() const { return m_frameIndex; }
+
+private:
+	AnimationSystem();
+	static void evaluateRange(void *pUserData, int begin, int end);
+
+	struct Entry
+	{
+		Component *m_pAnimSM;
+		EvaluateFunction m_evaluate;
+		PostStepFunction m_postStep;
+	};
+
+	Entry m_pending[PE_ANIMATION_SYSTEM_MAX_PENDING];
+	int m_numPending;
+	int m_numEvaluatedLastFlush;
+	PrimitiveTypes::UInt32 m_frameIndex;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
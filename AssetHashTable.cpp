@@ -0,0 +1,127 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "AssetHashTable.h"
+#include "MeshManager.h"
+
+namespace PE {
+namespace Components {
+
+AssetId::AssetId(const char *asset, const char *package)
+: m_hash(Hash(asset, package))
+, m_asset(asset)
+, m_package(package)
+{
+}
+
+PrimitiveTypes::UInt64 AssetId::Hash(const char *asset, const char *package)
+{
+	// same bytes as the "%s/%s" key MeshManager formats, without formatting it
+	PrimitiveTypes::UInt64 h = 14695981039346656037ULL;
+	for (const char *c = package; *c; ++c)
+		h = (h ^ (unsigned char)(*c)) * 1099511628211ULL;
+	h = (h ^ (unsigned char)('/')) * 1099511628211ULL;
+	for (const char *c = asset; *c; ++c)
+		h = (h ^ (unsigned char)(*c)) * 1099511628211ULL;
+	return h ? h : 1;
+}
+
+AssetHashTable *AssetHashTable::s_pInstance = NULL;
+Handle AssetHashTable::s_hInstance;
+
+void AssetHashTable::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle handle("ASSET_HASH_TABLE", sizeof(AssetHashTable));
+	s_pInstance = new(handle) AssetHashTable(context, arena);
+	s_hInstance = handle;
+}
+
+AssetHashTable::AssetHashTable(PE::GameContext &context, PE::MemoryArena arena)
+: m_hashes(context, arena, PE_ASSET_HASH_TABLE_CAPACITY)
+, m_keyOffsets(context, arena, PE_ASSET_HASH_TABLE_CAPACITY)
+, m_values(context, arena, PE_ASSET_HASH_TABLE_CAPACITY)
+, m_keyChars(context, arena, PE_ASSET_HASH_TABLE_KEY_CHARS)
+, m_numEntries(0)
+, m_pContext(&context)
+{
+	m_hashes.m_size = m_keyOffsets.m_size = m_values.m_size = PE_ASSET_HASH_TABLE_CAPACITY;
+	memset(m_hashes.getFirstPtr(), 0, sizeof(PrimitiveTypes::UInt64) * PE_ASSET_HASH_TABLE_CAPACITY);
+}
+
+bool AssetHashTable::keyMatches(int slot, const AssetId &id) const
+{
+	const char *key = &m_keyChars[m_keyOffsets[slot]];
+	const size_t packageLength = strlen(id.m_package);
+	return strncmp(key, id.m_package, packageLength) == 0
+		&& key[packageLength] == '/'
+		&& strcmp(key + packageLength + 1, id.m_asset) == 0;
+}
+
+int AssetHashTable::findSlot(const AssetId &id) const
+{
+	// add() stops at PE_ASSET_HASH_TABLE_MAX_ENTRIES so an empty slot ends the probe; the bound is
+	// only there so a full table cannot loop
+	int slot = (int)(id.m_hash & (PE_ASSET_HASH_TABLE_CAPACITY - 1));
+	for (int probe = 0; probe < PE_ASSET_HASH_TABLE_CAPACITY; ++probe)
+	{
+		const PrimitiveTypes::UInt64 h = m_hashes[slot];
+		if (h == 0 || (h == id.m_hash && keyMatches(slot, id)))
+			return slot;
+		slot = (slot + 1) & (PE_ASSET_HASH_TABLE_CAPACITY - 1);
+	}
+	return -1;
+}
+
+Handle AssetHashTable::find(const AssetId &id) const
+{
+	const int slot = findSlot(id);
+	return slot != -1 && m_hashes[slot] ? m_values[slot] : Handle();
+}
+
+bool AssetHashTable::add(const AssetId &id, const Handle &h)
+{
+	const int slot = findSlot(id);
+	if (slot != -1 && m_hashes[slot])
+	{
+		m_values[slot] = h;
+		return true;
+	}
+
+	const int packageLength = (int)(strlen(id.m_package));
+	const int assetLength = (int)(strlen(id.m_asset));
+	const int keyLength = packageLength + 1 + assetLength + 1;
+	if (slot == -1 || isFull() || m_keyChars.m_size + keyLength > PE_ASSET_HASH_TABLE_KEY_CHARS)
+	{
+		PEINFO("AssetHashTable: full, %s/%s is only found by name\n", id.m_package, id.m_asset);
+		return false;
+	}
+
+	char *key = m_keyChars.getFirstPtr() + m_keyChars.m_size;
+	memcpy(key, id.m_package, packageLength);
+	key[packageLength] = '/';
+	memcpy(key + packageLength + 1, id.m_asset, assetLength + 1);
+
+	m_hashes[slot] = id.m_hash;
+	m_keyOffsets[slot] = m_keyChars.m_size;
+	m_values[slot] = h;
+	m_keyChars.m_size += keyLength;
+	++m_numEntries;
+	return true;
+}
+
+Handle AssetHashTable::findOrLoad(const AssetId &id, int &threadOwnershipMask)
+{
+	Handle h = find(id);
+	if (h.isValid())
+		return h;
+	return m_pContext->getMeshManager()->getAsset(id.m_asset, id.m_package, threadOwnershipMask);
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,78 @@
+#ifndef __PYENGINE_2_0_ASSET_HASH_TABLE_H__
+#define __PYENGINE_2_0_ASSET_HASH_TABLE_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+
+// Sibling/Children includes
+
+#define PE_ASSET_HASH_TABLE_CAPACITY 2048 // slots, power of two
+#define PE_ASSET_HASH_TABLE_MAX_ENTRIES (PE_ASSET_HASH_TABLE_CAPACITY * 3 / 4)
+#define PE_ASSET_HASH_TABLE_KEY_CHARS (64 * 1024)
+
+namespace PE {
+namespace Components {
+
+// Asset name hashed once. Hot spawn paths keep one per asset instead of passing strings;
+// the strings are kept for verification and for loading on a miss, so they must outlive the id
+struct AssetId
+{
+	AssetId(const char *asset, const char *package);
+
+	// FNV-1a of "package/asset", never 0
+	static PrimitiveTypes::UInt64 Hash(const char *asset, const char *package);
+
+	PrimitiveTypes::UInt64 m_hash;
+	const char *m_asset;
+	const char *m_package;
+};
+
+// MeshManager's assets (meshes and skeletons) by AssetId. Open addressing with linear probing over the
+// hashes only; a hash match is confirmed against the stored "package/asset" key, so colliding names
+// are still told apart. Fixed capacity; once full, add() refuses new assets and MeshManager finds them by
+// name in m_assets. Entries are never removed
+struct AssetHashTable
+{
+	AssetHashTable(PE::GameContext &context, PE::MemoryArena arena);
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static AssetHashTable *Instance() { return s_pInstance; }
+
+	// invalid handle when the asset is not loaded
+	Handle find(const AssetId &id) const;
+	bool add(const AssetId &id, const Handle &h); // false when the table is full
+
+	// find(), or MeshManager::getAsset() on a miss
+	Handle findOrLoad(const AssetId &id, int &threadOwnershipMask);
+
+	int getNumEntries() const { return m_numEntries; }
+	bool isFull() const { return m_numEntries >= PE_ASSET_HASH_TABLE_MAX_ENTRIES; }
+
+private:
+	int findSlot(const AssetId &id) const; // slot of id, or the empty slot where it goes; -1 when neither
+	bool keyMatches(int slot, const AssetId &id) const;
+
+	Array<PrimitiveTypes::UInt64> m_hashes; // 0 = empty
+	Array<PrimitiveTypes::UInt32> m_keyOffsets; // into m_keyChars
+	Array<Handle> m_values;
+	Array<char> m_keyChars; // "package/asset\0" per entry
+	int m_numEntries;
+
+	PE::GameContext *m_pContext;
+
+	static AssetHashTable *s_pInstance;
+	static Handle s_hInstance;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
@@ -0,0 +1,332 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+#include <float.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Events/StandardEvents.h"
+#include "PrimeEngine/Utils/PEString.h"
+
+// Sibling/Children includes
+#include "AsyncMeshLoader.h"
+#include "MeshManager.h"
+#include "MeshInstance.h"
+#include "SkeletonInstance.h"
+#include "PrimeEngine/Scene/RootSceneNode.h"
+#include "AssetHashTable.h"
+
+namespace PE {
+namespace Components {
+
+using namespace PE::Events;
+
+PE_IMPLEMENT_CLASS1(AsyncMeshLoader, Component);
+
+AsyncMeshLoader *AsyncMeshLoader::s_pInstance = NULL;
+Handle AsyncMeshLoader::s_hInstance;
+
+void AsyncMeshLoader::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle handle("AsyncMeshLoader", sizeof(AsyncMeshLoader));
+	AsyncMeshLoader *pLoader = new(handle) AsyncMeshLoader(context, arena, handle);
+	pLoader->addDefaultComponents();
+	s_pInstance = pLoader;
+	s_hInstance = handle;
+	RootSceneNode::Instance()->addComponent(handle);
+}
+
+AsyncMeshLoader::AsyncMeshLoader(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself)
+: Component(context, arena, hMyself)
+, m_pFinalizing(NULL)
+, m_quit(false)
+{
+	for (int i = 0; i < PE_ASYNC_MESH_LOADER_MAX_REQUESTS; ++i)
+	{
+		m_requests[i].m_state = RequestState_Free;
+		m_requests[i].m_refCount = 0;
+		m_requests[i].m_numWaitingInstances = 0;
+	}
+
+	m_ioThread = std::thread(&AsyncMeshLoader::ioMain, this);
+}
+
+AsyncMeshLoader::~AsyncMeshLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	m_ioThread.join();
+}
+
+void AsyncMeshLoader::addDefaultComponents()
+{
+	Component::addDefaultComponents();
+
+	PE_REGISTER_EVENT_HANDLER(Events::Event_PRE_RENDER_needsRC, AsyncMeshLoader::do_PRE_RENDER_needsRC);
+}
+
+int AsyncMeshLoader::request(const char *asset, const char *package)
+{
+	return request(AssetId(asset, package));
+}
+
+int AsyncMeshLoader::request(const AssetId &id)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// loading or loaded through this loader
+	int freeSlot = -1;
+	for (int i = 0; i < PE_ASYNC_MESH_LOADER_MAX_REQUESTS; ++i)
+	{
+		Request &r = m_requests[i];
+		if (r.m_state == RequestState_Free)
+		{
+			if (freeSlot == -1)
+				freeSlot = i;
+			continue;
+		}
+		if (r.m_assetHash == id.m_hash && strcmp(r.m_asset, id.m_asset) == 0 && strcmp(r.m_package, id.m_package) == 0)
+		{
+			++r.m_refCount;
+			return i;
+		}
+	}
+
+	if (freeSlot == -1)
+		return -1;
+
+	Request &r = m_requests[freeSlot];
+	snprintf(r.m_key, sizeof(r.m_key), "%s/%s", id.m_package, id.m_asset);
+	snprintf(r.m_asset, sizeof(r.m_asset), "%s", id.m_asset);
+	snprintf(r.m_package, sizeof(r.m_package), "%s", id.m_package);
+	r.m_assetHash = id.m_hash;
+	r.m_refCount = 1;
+	r.m_numWaitingInstances = 0;
+	r.m_hResult = Handle();
+
+	// loaded synchronously before
+	Handle hLoaded = AssetHashTable::Instance() ? AssetHashTable::Instance()->find(id) : Handle();
+	if (hLoaded.isValid())
+	{
+		r.m_hResult = hLoaded;
+		r.m_state = RequestState_Ready;
+		return freeSlot;
+	}
+
+	PEString::generatePathname(*m_pContext, id.m_asset, id.m_package, "Meshes", r.m_sourcePath, sizeof(r.m_sourcePath));
+	r.m_state = RequestState_Queued;
+	m_wake.notify_one();
+	return freeSlot;
+}
+
+void AsyncMeshLoader::release(int requestId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Request &r = m_requests[requestId];
+	PEASSERT(r.m_refCount > 0, "Request released too often");
+
+	// loads in flight finish anyway; the slot is freed when they do
+	if (--r.m_refCount == 0 && r.m_state == RequestState_Ready)
+		r.m_state = RequestState_Free;
+}
+
+bool AsyncMeshLoader::bindWhenReady(int requestId, Handle hMeshInstance)
+{
+	Request &r = m_requests[requestId];
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (r.m_state != RequestState_Ready)
+		{
+			if (r.m_numWaitingInstances == PE_ASYNC_MESH_LOADER_MAX_WAITING_INSTANCES)
+				return false;
+			r.m_waitingInstances[r.m_numWaitingInstances++] = hMeshInstance;
+			return true;
+		}
+	}
+	bindInstance(r, hMeshInstance);
+	return true;
+}
+
+void AsyncMeshLoader::cancelWaiting(MeshInstance *pMeshInstance)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (int iRequest = 0; iRequest < PE_ASYNC_MESH_LOADER_MAX_REQUESTS; ++iRequest)
+	{
+		Request &r = m_requests[iRequest];
+		for (int i = 0; i < r.m_numWaitingInstances; ++i)
+		{
+			if (r.m_waitingInstances[i].getObject<MeshInstance>() == pMeshInstance)
+			{
+				r.m_waitingInstances[i] = r.m_waitingInstances[--r.m_numWaitingInstances];
+				return;
+			}
+		}
+	}
+}
+
+bool AsyncMeshLoader::isReady(int requestId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_requests[requestId].m_state == RequestState_Ready;
+}
+
+Handle AsyncMeshLoader::getResult(int requestId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_requests[requestId].m_hResult;
+}
+
+MeshLoadStaging *AsyncMeshLoader::findStaging(const char *key)
+{
+	if (m_pFinalizing && strcmp(m_pFinalizing->m_key, key) == 0)
+		return &m_pFinalizing->m_staging;
+	return NULL;
+}
+
+void AsyncMeshLoader::ioMain()
+{
+	for (;;)
+	{
+		Request *pRequest = NULL;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			for (;;)
+			{
+				if (m_quit)
+					return;
+				for (int i = 0; i < PE_ASYNC_MESH_LOADER_MAX_REQUESTS && !pRequest; ++i)
+				{
+					if (m_requests[i].m_state == RequestState_Queued)
+						pRequest = &m_requests[i];
+				}
+				if (pRequest)
+					break;
+				m_wake.wait(lock);
+			}
+			pRequest->m_state = RequestState_Staging;
+		}
+
+		stage(*pRequest);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		pRequest->m_state = RequestState_Staged;
+	}
+}
+
+// IO thread. Only touches the request's own staging
+void AsyncMeshLoader::stage(Request &r)
+{
+	MeshLoadStaging &s = r.m_staging;
+	s.m_haveBounds = false;
+	s.m_haveBinary = s.m_binaryMesh.open(r.m_sourcePath);
+
+	// text meshes are parsed on the RC thread
+	if (!s.m_haveBinary)
+		return;
+
+	// fault the mapping in here, not during the upload
+	const BinaryMeshHeader &header = s.m_binaryMesh.getHeader();
+	const volatile char *pBytes = (const volatile char *)(&header);
+	char sum = 0;
+	for (PrimitiveTypes::UInt32 offset = 0; offset < header.m_fileSize; offset += 4096)
+		sum += pBytes[offset];
+	(void)sum;
+
+	// bounds on this thread: the job pool takes one parallelFor at a time and the animation flush
+	// on the main thread must not wait behind a mesh
+	const PrimitiveTypes::Float32 *pPositions = s.m_binaryMesh.getBlock<PrimitiveTypes::Float32>(BinaryMeshBlock_Positions);
+	for (int i = 0; i < 3; ++i)
+	{
+		s.m_min[i] = FLT_MAX;
+		s.m_max[i] = -FLT_MAX;
+	}
+	for (PrimitiveTypes::UInt32 iv = 0; iv < header.m_numVertices; ++iv)
+	{
+		const PrimitiveTypes::Float32 *p = &pPositions[iv * 3];
+		for (int i = 0; i < 3; ++i)
+		{
+			s.m_min[i] = p[i] < s.m_min[i] ? p[i] : s.m_min[i];
+			s.m_max[i] = p[i] > s.m_max[i] ? p[i] : s.m_max[i];
+		}
+	}
+	s.m_haveBounds = header.m_numVertices > 0;
+}
+
+void AsyncMeshLoader::finalize(Request &r, int &threadOwnershipMask)
+{
+	m_pFinalizing = &r;
+	Handle h = m_pContext->getMeshManager()->getAsset(r.m_asset, r.m_package, threadOwnershipMask);
+	m_pFinalizing = NULL;
+	r.m_staging.m_binaryMesh.close();
+
+	// bindWhenReady() never adds past the cap, so the copy fits
+	Handle waiting[PE_ASYNC_MESH_LOADER_MAX_WAITING_INSTANCES];
+	int numWaiting = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		r.m_hResult = h;
+		r.m_state = r.m_refCount ? RequestState_Ready : RequestState_Free;
+		numWaiting = r.m_numWaitingInstances;
+		for (int i = 0; i < numWaiting; ++i)
+			waiting[i] = r.m_waitingInstances[i];
+		r.m_numWaitingInstances = 0;
+	}
+
+	for (int i = 0; i < numWaiting; ++i)
+		bindInstance(r, waiting[i]);
+}
+
+void AsyncMeshLoader::bindInstance(Request &r, Handle hMeshInstance)
+{
+	// destroyed instances leave the waiting list (cancelWaiting), so a waiting handle is live;
+	// one that has a mesh already was bound another way
+	if (!hMeshInstance.isValid())
+		return;
+	Handle hMesh = r.m_hResult;
+	MeshInstance *pMeshInstance = hMeshInstance.getObject<MeshInstance>();
+	if (pMeshInstance->m_hAsset.isValid() || !hMesh.isValid())
+		return;
+	pMeshInstance->initFromRegisteredAsset(hMesh);
+	pMeshInstance->createPhysicsManager(hMesh);
+
+	// a skin that arrives after its skeleton went idle: the bind pose shortcut and the pose bounds
+	// were computed without it
+	SkeletonInstance *pSkelInst = pMeshInstance->getFirstParentByTypePtr<SkeletonInstance>();
+	if (pSkelInst)
+	{
+		pSkelInst->m_paletteIsBindPose = false;
+		pSkelInst->m_hasPoseBounds = false;
+	}
+}
+
+// this event is executed when thread has RC
+void AsyncMeshLoader::do_PRE_RENDER_needsRC(Events::Event *pEvt)
+{
+	Event_PRE_RENDER_needsRC *pRealEvt = (Event_PRE_RENDER_needsRC *)(pEvt);
+
+	// a few uploads per frame so a level streaming in does not stall one frame
+	for (int iFinalized = 0; iFinalized < PE_ASYNC_MESH_LOADER_MAX_FINALIZE_PER_FRAME; ++iFinalized)
+	{
+		Request *pRequest = NULL;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (int i = 0; i < PE_ASYNC_MESH_LOADER_MAX_REQUESTS && !pRequest; ++i)
+			{
+				if (m_requests[i].m_state == RequestState_Staged)
+					pRequest = &m_requests[i];
+			}
+		}
+		if (!pRequest)
+			break;
+
+		finalize(*pRequest, pRealEvt->m_threadOwnershipMask);
+	}
+}
+
+}; // namespace Components
+}; // namespace PE
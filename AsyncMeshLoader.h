@@ -0,0 +1,133 @@
+#ifndef __PYENGINE_2_0_ASYNC_MESH_LOADER_H__
+#define __PYENGINE_2_0_ASYNC_MESH_LOADER_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "../Events/Component.h"
+
+// Sibling/Children includes
+#include "BinaryMesh.h"
+#include "AssetHashTable.h"
+
+#define PE_ASYNC_MESH_LOADER_MAX_REQUESTS 64
+#define PE_ASYNC_MESH_LOADER_MAX_WAITING_INSTANCES 16 // MeshInstances bound when one request resolves; more load synchronously
+#define PE_ASYNC_MESH_LOADER_MAX_FINALIZE_PER_FRAME 2  // GPU uploads per Event_PRE_RENDER_needsRC
+#define PE_ASYNC_MESH_LOADER_MAX_NAME 128
+
+namespace PE {
+namespace Components {
+
+struct MeshInstance;
+
+// What the IO thread prepared for one mesh; MeshManager::getAsset uses it instead of
+// opening and scanning the file again
+struct MeshLoadStaging
+{
+	BinaryMesh m_binaryMesh;
+	bool m_haveBinary;
+	bool m_haveBounds;
+	PrimitiveTypes::Float32 m_min[3];
+	PrimitiveTypes::Float32 m_max[3];
+};
+
+// Staged mesh loading:
+//   IO thread     maps and validates the binary mesh, pages it in and computes local bounds from the
+//                 mapped positions (not on the job pool, which serves one parallelFor at a time)
+//   RC thread     MeshManager::getAsset (MeshCPU, GPU upload, PhysicsManager) in Event_PRE_RENDER_needsRC,
+//                 then binds the MeshInstances waiting on the request
+// Engine handles are only allocated in the last stage. Meshes without a binary file are parsed there too.
+// Requests are ids; requests for a key that is loading or loaded share the same id and result.
+struct AsyncMeshLoader : public Component
+{
+	PE_DECLARE_CLASS(AsyncMeshLoader);
+
+	enum ERequestState
+	{
+		RequestState_Free,
+		RequestState_Queued,  // waiting for the IO thread
+		RequestState_Staging, // IO thread
+		RequestState_Staged,  // waiting for the RC thread
+		RequestState_Ready,
+	};
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static AsyncMeshLoader *Instance() { return s_pInstance; }
+
+	// Constructor -------------------------------------------------------------
+	AsyncMeshLoader(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself);
+	virtual ~AsyncMeshLoader();
+
+	// Methods -----------------------------------------------------------------
+
+	// Returns a request id, -1 when all request slots are used (load synchronously then).
+	// Every request() is matched by a release()
+	int request(const char *asset, const char *package);
+	int request(const AssetId &id);
+	void release(int requestId);
+
+	// hMeshInstance gets initFromRegisteredAsset() and createPhysicsManager() once the mesh is ready
+	// (right away if it already is). false when the request's waiting list is full; load synchronously then
+	bool bindWhenReady(int requestId, Handle hMeshInstance);
+
+	// Takes an instance destroyed before its mesh was ready off the waiting lists
+	void cancelWaiting(MeshInstance *pMeshInstance);
+
+	bool isReady(int requestId);
+	Handle getResult(int requestId); // invalid until isReady()
+
+	// Staged data of the mesh being finalized, for MeshManager::getAsset. NULL for any other key
+	MeshLoadStaging *findStaging(const char *key);
+
+	// Component ---------------------------------------------------------------
+	virtual void addDefaultComponents();
+
+	PE_DECLARE_IMPLEMENT_EVENT_HANDLER_WRAPPER(do_PRE_RENDER_needsRC);
+	virtual void do_PRE_RENDER_needsRC(Events::Event *pEvt);
+
+private:
+	struct Request
+	{
+		ERequestState m_state;
+		int m_refCount;
+		char m_key[PE_ASYNC_MESH_LOADER_MAX_NAME];
+		char m_asset[PE_ASYNC_MESH_LOADER_MAX_NAME];
+		char m_package[PE_ASYNC_MESH_LOADER_MAX_NAME];
+		PrimitiveTypes::UInt64 m_assetHash; // AssetId::m_hash; names are compared only on a match
+		char m_sourcePath[512];
+		MeshLoadStaging m_staging;
+		Handle m_hResult;
+		Handle m_waitingInstances[PE_ASYNC_MESH_LOADER_MAX_WAITING_INSTANCES];
+		int m_numWaitingInstances;
+	};
+
+	void ioMain();
+	void stage(Request &r);
+	void finalize(Request &r, int &threadOwnershipMask);
+	void bindInstance(Request &r, Handle hMeshInstance);
+
+	static AsyncMeshLoader *s_pInstance;
+	static Handle s_hInstance;
+
+	Request m_requests[PE_ASYNC_MESH_LOADER_MAX_REQUESTS];
+	Request *m_pFinalizing;
+
+	std::thread m_ioThread;
+	std::mutex m_mutex; // request states
+	std::condition_variable m_wake;
+	bool m_quit;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
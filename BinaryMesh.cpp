@@ -0,0 +1,443 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Geometry/MeshCPU/MeshCPU.h"
+#include "PrimeEngine/Geometry/IndexBufferCPU/IndexBufferCPU.h"
+#include "PrimeEngine/Geometry/MaterialCPU/MaterialSetCPU.h"
+#include "PrimeEngine/Utils/PEString.h"
+
+// Sibling/Children includes
+#include "BinaryMesh.h"
+
+namespace PE {
+namespace Components {
+
+static const PrimitiveTypes::UInt32 s_blockElementSizes[BinaryMeshBlock_Count] =
+{
+	3 * sizeof(PrimitiveTypes::Float32),
+	3 * sizeof(PrimitiveTypes::Float32),
+	3 * sizeof(PrimitiveTypes::Float32),
+	2 * sizeof(PrimitiveTypes::Float32),
+	sizeof(PrimitiveTypes::UInt16),
+	sizeof(BinaryMeshIndexRange),
+	sizeof(BinaryMeshBoneSegment),
+	sizeof(PrimitiveTypes::Int32),
+	sizeof(PrimitiveTypes::UInt32),
+	sizeof(BinaryMeshSkinWeight),
+};
+
+BinaryMesh::BinaryMesh()
+: m_pHeader(NULL)
+{
+}
+
+void BinaryMesh::MakePath(const char *sourcePath, char *outPath, int outSize)
+{
+	snprintf(outPath, outSize, "%s%s", sourcePath, PE_BINARY_MESH_EXTENSION);
+}
+
+bool BinaryMesh::open(const char *sourcePath)
+{
+	close();
+
+	char path[512];
+	MakePath(sourcePath, path, sizeof(path));
+	if (!m_file.openBaked(path, sourcePath, PE_BINARY_MESH_MAGIC, PE_BINARY_MESH_VERSION,
+		sizeof(BinaryMeshHeader), offsetof(BinaryMeshHeader, m_source)))
+		return false;
+
+	const BinaryMeshHeader *pHeader = (const BinaryMeshHeader *)(m_file.getData());
+	bool valid = pHeader->m_materialSetFile[PE_BINARY_MESH_MAX_NAME - 1] == '\0';
+
+	for (int i = 0; valid && i < BinaryMeshBlock_Count; ++i)
+	{
+		const BinaryMeshBlock &b = pHeader->m_blocks[i];
+		valid = b.m_elementSize == s_blockElementSizes[i]
+			&& b.m_offset % PE_BINARY_MESH_BLOCK_ALIGNMENT == 0
+			&& (PrimitiveTypes::UInt64)(b.m_offset) + (PrimitiveTypes::UInt64)(b.m_count) * b.m_elementSize <= pHeader->m_fileSize;
+	}
+
+	// cross references are checked once here so fillMeshCPU() can trust them
+	if (valid)
+	{
+		const BinaryMeshBlock *blocks = pHeader->m_blocks;
+		const PrimitiveTypes::UInt32 numVertices = pHeader->m_numVertices;
+		valid = blocks[BinaryMeshBlock_Positions].m_count == numVertices
+			&& (blocks[BinaryMeshBlock_Normals].m_count == 0 || blocks[BinaryMeshBlock_Normals].m_count == numVertices)
+			&& (blocks[BinaryMeshBlock_Tangents].m_count == 0 || blocks[BinaryMeshBlock_Tangents].m_count == numVertices)
+			&& (blocks[BinaryMeshBlock_TexCoords].m_count == 0 || blocks[BinaryMeshBlock_TexCoords].m_count == numVertices)
+			&& (blocks[BinaryMeshBlock_SkinWeightCounts].m_count == 0 || blocks[BinaryMeshBlock_SkinWeightCounts].m_count == numVertices);
+
+		const char *pBase = (const char *)(pHeader);
+		const BinaryMeshIndexRange *pRanges = (const BinaryMeshIndexRange *)(pBase + blocks[BinaryMeshBlock_IndexRanges].m_offset);
+		for (PrimitiveTypes::UInt32 i = 0; valid && i < blocks[BinaryMeshBlock_IndexRanges].m_count; ++i)
+			valid = (PrimitiveTypes::UInt64)(pRanges[i].m_firstBoneSegment) + pRanges[i].m_numBoneSegments <= blocks[BinaryMeshBlock_BoneSegments].m_count;
+
+		const BinaryMeshBoneSegment *pSegments = (const BinaryMeshBoneSegment *)(pBase + blocks[BinaryMeshBlock_BoneSegments].m_offset);
+		for (PrimitiveTypes::UInt32 i = 0; valid && i < blocks[BinaryMeshBlock_BoneSegments].m_count; ++i)
+			valid = (PrimitiveTypes::UInt64)(pSegments[i].m_firstBone) + pSegments[i].m_numBones <= blocks[BinaryMeshBlock_BoneSegmentBones].m_count;
+
+		const PrimitiveTypes::UInt32 *pCounts = (const PrimitiveTypes::UInt32 *)(pBase + blocks[BinaryMeshBlock_SkinWeightCounts].m_offset);
+		PrimitiveTypes::UInt64 numWeights = 0;
+		for (PrimitiveTypes::UInt32 i = 0; valid && i < blocks[BinaryMeshBlock_SkinWeightCounts].m_count; ++i)
+			numWeights += pCounts[i];
+		valid = valid && numWeights == blocks[BinaryMeshBlock_SkinWeights].m_count;
+	}
+
+	if (!valid)
+	{
+		m_file.close();
+		return false;
+	}
+
+	m_pHeader = pHeader;
+	return true;
+}
+
+void BinaryMesh::close()
+{
+	m_pHeader = NULL;
+	m_file.close();
+}
+
+static void copyFloats(Array<PrimitiveTypes::Float32> &dst, const PrimitiveTypes::Float32 *pSrc, int count)
+{
+	dst.reset(count);
+	memcpy(dst.getFirstPtr(), pSrc, count * sizeof(PrimitiveTypes::Float32));
+	dst.m_size = count;
+}
+
+void BinaryMesh::fillVertexBuffers(PE::GameContext &context, PE::MemoryArena arena,
+	Handle &hPositions, Handle &hNormals, Handle &hTangents, Handle &hTexCoords) const
+{
+	PEASSERT(m_pHeader, "Binary mesh is not open");
+	const BinaryMeshBlock *blocks = m_pHeader->m_blocks;
+	const int numVertices = (int)(m_pHeader->m_numVertices);
+
+	hPositions = Handle("VERTEX_BUFFER_CPU", sizeof(PositionBufferCPU));
+	PositionBufferCPU *pPositions = new(hPositions) PositionBufferCPU(context, arena);
+	copyFloats(pPositions->m_values, getBlock<PrimitiveTypes::Float32>(BinaryMeshBlock_Positions), numVertices * 3);
+
+	if (blocks[BinaryMeshBlock_Normals].m_count)
+	{
+		hNormals = Handle("NORMAL_BUFFER_CPU", sizeof(NormalBufferCPU));
+		NormalBufferCPU *pNormals = new(hNormals) NormalBufferCPU(context, arena);
+		copyFloats(pNormals->m_values, getBlock<PrimitiveTypes::Float32>(BinaryMeshBlock_Normals), numVertices * 3);
+	}
+
+	if (blocks[BinaryMeshBlock_Tangents].m_count)
+	{
+		hTangents = Handle("TANGENT_BUFFER_CPU", sizeof(TangentBufferCPU));
+		TangentBufferCPU *pTangents = new(hTangents) TangentBufferCPU(context, arena);
+		copyFloats(pTangents->m_values, getBlock<PrimitiveTypes::Float32>(BinaryMeshBlock_Tangents), numVertices * 3);
+	}
+
+	if (blocks[BinaryMeshBlock_TexCoords].m_count)
+	{
+		hTexCoords = Handle("TEXCOORD_BUFFER_CPU", sizeof(TexCoordBufferCPU));
+		TexCoordBufferCPU *pTexCoords = new(hTexCoords) TexCoordBufferCPU(context, arena);
+		copyFloats(pTexCoords->m_values, getBlock<PrimitiveTypes::Float32>(BinaryMeshBlock_TexCoords), numVertices * 2);
+	}
+}
+
+void BinaryMesh::fillMeshCPU(PE::GameContext &context, PE::MemoryArena arena, MeshCPU &mcpu, const char *package) const
+{
+	PEASSERT(m_pHeader, "Binary mesh is not open");
+	const BinaryMeshHeader &header = *m_pHeader;
+	const BinaryMeshBlock *blocks = header.m_blocks;
+	const int numVertices = (int)(header.m_numVertices);
+
+	fillVertexBuffers(context, arena, mcpu.m_hPositionBufferCPU, mcpu.m_hNormalBufferCPU, mcpu.m_hTangentBufferCPU, mcpu.m_hTexCoordBufferCPU);
+
+	// indices, their ranges and the joint segments of each range
+	mcpu.m_hIndexBufferCPU = Handle("INDEX_BUFFER_CPU", sizeof(IndexBufferCPU));
+	IndexBufferCPU *pIndices = new(mcpu.m_hIndexBufferCPU) IndexBufferCPU(context, arena);
+	const int numIndices = (int)(blocks[BinaryMeshBlock_Indices].m_count);
+	pIndices->m_values.reset(numIndices);
+	memcpy(pIndices->m_values.getFirstPtr(), getBlock<PrimitiveTypes::UInt16>(BinaryMeshBlock_Indices), numIndices * sizeof(PrimitiveTypes::UInt16));
+	pIndices->m_values.m_size = numIndices;
+	pIndices->m_primitiveTopology = (PEPrimitveTopology)(header.m_primitiveTopology);
+	pIndices->m_verticesPerPolygon = header.m_verticesPerPolygon;
+	pIndices->m_minVertexIndex = header.m_minVertexIndex;
+	pIndices->m_maxVertexIndex = header.m_maxVertexIndex;
+
+	const BinaryMeshIndexRange *pRanges = getBlock<BinaryMeshIndexRange>(BinaryMeshBlock_IndexRanges);
+	const BinaryMeshBoneSegment *pSegments = getBlock<BinaryMeshBoneSegment>(BinaryMeshBlock_BoneSegments);
+	const PrimitiveTypes::Int32 *pBones = getBlock<PrimitiveTypes::Int32>(BinaryMeshBlock_BoneSegmentBones);
+	const int numRanges = (int)(blocks[BinaryMeshBlock_IndexRanges].m_count);
+	pIndices->m_indexRanges.reset(numRanges);
+	pIndices->m_indexRanges.m_size = numRanges;
+	for (int ir = 0; ir < numRanges; ++ir)
+	{
+		const BinaryMeshIndexRange &src = pRanges[ir];
+		IndexRange *pRange = new(&pIndices->m_indexRanges[ir]) IndexRange(context, arena);
+		pRange->m_start = src.m_start;
+		pRange->m_end = src.m_end;
+		pRange->m_minVertIndex = src.m_minVertIndex;
+		pRange->m_maxVertIndex = src.m_maxVertIndex;
+
+		pRange->m_boneSegments.reset(src.m_numBoneSegments);
+		pRange->m_boneSegments.m_size = src.m_numBoneSegments;
+		for (PrimitiveTypes::UInt32 is = 0; is < src.m_numBoneSegments; ++is)
+		{
+			const BinaryMeshBoneSegment &srcSegment = pSegments[src.m_firstBoneSegment + is];
+			IndexRange::BoneSegment *pSegment = new(&pRange->m_boneSegments[is]) IndexRange::BoneSegment(context, arena);
+			pSegment->m_start = srcSegment.m_start;
+			pSegment->m_end = srcSegment.m_end;
+			pSegment->m_boneSegmentBones.reset(srcSegment.m_numBones);
+			for (PrimitiveTypes::UInt32 ib = 0; ib < srcSegment.m_numBones; ++ib)
+				pSegment->m_boneSegmentBones.add(pBones[srcSegment.m_firstBone + ib]);
+		}
+	}
+
+	if (blocks[BinaryMeshBlock_SkinWeightCounts].m_count)
+	{
+		mcpu.m_hSkinWeightsCPU = Handle("SKIN_WEIGHTS_CPU", sizeof(SkinWeightsCPU));
+		SkinWeightsCPU *pWeights = new(mcpu.m_hSkinWeightsCPU) SkinWeightsCPU(context, arena);
+		const PrimitiveTypes::UInt32 *pCounts = getBlock<PrimitiveTypes::UInt32>(BinaryMeshBlock_SkinWeightCounts);
+		const BinaryMeshSkinWeight *pSrc = getBlock<BinaryMeshSkinWeight>(BinaryMeshBlock_SkinWeights);
+
+		pWeights->m_weightsPerVertex.reset(numVertices);
+		pWeights->m_weightsPerVertex.m_size = numVertices;
+		for (int iv = 0; iv < numVertices; ++iv)
+		{
+			Array<WeightPair> *pVertexWeights = new(&pWeights->m_weightsPerVertex[iv]) Array<WeightPair>(context, arena);
+			pVertexWeights->reset(pCounts[iv]);
+			pVertexWeights->m_size = pCounts[iv];
+			for (PrimitiveTypes::UInt32 iw = 0; iw < pCounts[iv]; ++iw, ++pSrc)
+			{
+				(*pVertexWeights)[iw].m_jointIndex = pSrc->m_jointIndex;
+				(*pVertexWeights)[iw].m_weight = pSrc->m_weight;
+			}
+		}
+	}
+
+	// materials are a few lines of text referencing textures, not worth a binary form
+	mcpu.m_hMaterialSetCPU = Handle("MATERIAL_SET_CPU", sizeof(MaterialSetCPU));
+	MaterialSetCPU *pMaterials = new(mcpu.m_hMaterialSetCPU) MaterialSetCPU(context, arena);
+	pMaterials->ReadMaterialSet(header.m_materialSetFile, package);
+}
+
+// Writes zeros up to offset
+static bool padTo(FILE *f, PrimitiveTypes::UInt32 &pos, PrimitiveTypes::UInt32 offset)
+{
+	static const char zeros[PE_BINARY_MESH_BLOCK_ALIGNMENT] = {0};
+	const PrimitiveTypes::UInt32 n = offset - pos;
+	pos = offset;
+	return n == 0 || fwrite(zeros, n, 1, f) == 1;
+}
+
+static bool writeBlock(FILE *f, PrimitiveTypes::UInt32 &pos, const BinaryMeshBlock &block, const void *pData)
+{
+	const PrimitiveTypes::UInt32 size = block.m_count * block.m_elementSize;
+	if (!padTo(f, pos, block.m_offset))
+		return false;
+	pos += size;
+	return size == 0 || fwrite(pData, size, 1, f) == 1;
+}
+
+bool BinaryMesh::Write(const char *sourcePath, const BakedSource &source, MeshCPU &mcpu, const char *materialSetFile)
+{
+	PositionBufferCPU *pPositions = mcpu.m_hPositionBufferCPU.getObject<PositionBufferCPU>();
+	NormalBufferCPU *pNormals = mcpu.m_hNormalBufferCPU.isValid() ? mcpu.m_hNormalBufferCPU.getObject<NormalBufferCPU>() : NULL;
+	TangentBufferCPU *pTangents = mcpu.m_hTangentBufferCPU.isValid() ? mcpu.m_hTangentBufferCPU.getObject<TangentBufferCPU>() : NULL;
+	TexCoordBufferCPU *pTexCoords = mcpu.m_hTexCoordBufferCPU.isValid() ? mcpu.m_hTexCoordBufferCPU.getObject<TexCoordBufferCPU>() : NULL;
+	IndexBufferCPU *pIndices = mcpu.m_hIndexBufferCPU.getObject<IndexBufferCPU>();
+	SkinWeightsCPU *pWeights = mcpu.m_hSkinWeightsCPU.isValid() ? mcpu.m_hSkinWeightsCPU.getObject<SkinWeightsCPU>() : NULL;
+
+	if (strlen(materialSetFile) >= PE_BINARY_MESH_MAX_NAME)
+		return false;
+
+	BinaryMeshHeader header;
+	memset(&header, 0, sizeof(header));
+	header.m_magic = PE_BINARY_MESH_MAGIC;
+	header.m_version = PE_BINARY_MESH_VERSION;
+	header.m_numVertices = pPositions->m_values.m_size / 3;
+	header.m_primitiveTopology = (PrimitiveTypes::UInt32)(pIndices->m_primitiveTopology);
+	header.m_verticesPerPolygon = pIndices->m_verticesPerPolygon;
+	header.m_minVertexIndex = pIndices->m_minVertexIndex;
+	header.m_maxVertexIndex = pIndices->m_maxVertexIndex;
+	strcpy(header.m_materialSetFile, materialSetFile);
+	header.m_source = source;
+
+	BinaryMeshBlock *blocks = header.m_blocks;
+	blocks[BinaryMeshBlock_Positions].m_count = header.m_numVertices;
+	blocks[BinaryMeshBlock_Normals].m_count = pNormals ? header.m_numVertices : 0;
+	blocks[BinaryMeshBlock_Tangents].m_count = pTangents ? header.m_numVertices : 0;
+	blocks[BinaryMeshBlock_TexCoords].m_count = pTexCoords ? header.m_numVertices : 0;
+	blocks[BinaryMeshBlock_Indices].m_count = pIndices->m_values.m_size;
+	blocks[BinaryMeshBlock_IndexRanges].m_count = pIndices->m_indexRanges.m_size;
+	for (PrimitiveTypes::UInt32 ir = 0; ir < pIndices->m_indexRanges.m_size; ++ir)
+	{
+		IndexRange &range = pIndices->m_indexRanges[ir];
+		blocks[BinaryMeshBlock_BoneSegments].m_count += range.m_boneSegments.m_size;
+		for (PrimitiveTypes::UInt32 is = 0; is < range.m_boneSegments.m_size; ++is)
+			blocks[BinaryMeshBlock_BoneSegmentBones].m_count += range.m_boneSegments[is].m_boneSegmentBones.m_size;
+	}
+	if (pWeights)
+	{
+		blocks[BinaryMeshBlock_SkinWeightCounts].m_count = header.m_numVertices;
+		for (PrimitiveTypes::UInt32 iv = 0; iv < header.m_numVertices; ++iv)
+			blocks[BinaryMeshBlock_SkinWeights].m_count += pWeights->m_weightsPerVertex[iv].m_size;
+	}
+
+	PrimitiveTypes::UInt32 offset = sizeof(BinaryMeshHeader);
+	for (int i = 0; i < BinaryMeshBlock_Count; ++i)
+	{
+		offset = (offset + PE_BINARY_MESH_BLOCK_ALIGNMENT - 1) & ~(PrimitiveTypes::UInt32)(PE_BINARY_MESH_BLOCK_ALIGNMENT - 1);
+		blocks[i].m_offset = offset;
+		blocks[i].m_elementSize = s_blockElementSizes[i];
+		offset += blocks[i].m_count * blocks[i].m_elementSize;
+	}
+	header.m_fileSize = offset;
+
+	char path[512];
+	MakePath(sourcePath, path, sizeof(path));
+	FILE *f = fopen(path, "wb");
+	if (!f)
+		return false;
+
+	PrimitiveTypes::UInt32 pos = sizeof(header);
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	ok = ok && writeBlock(f, pos, blocks[BinaryMeshBlock_Positions], pPositions->m_values.getFirstPtr());
+	ok = ok && writeBlock(f, pos, blocks[BinaryMeshBlock_Normals], pNormals ? pNormals->m_values.getFirstPtr() : NULL);
+	ok = ok && writeBlock(f, pos, blocks[BinaryMeshBlock_Tangents], pTangents ? pTangents->m_values.getFirstPtr() : NULL);
+	ok = ok && writeBlock(f, pos, blocks[BinaryMeshBlock_TexCoords], pTexCoords ? pTexCoords->m_values.getFirstPtr() : NULL);
+	ok = ok && writeBlock(f, pos, blocks[BinaryMeshBlock_Indices], pIndices->m_values.getFirstPtr());
+
+	// ranges, segments and bones are flattened with first/count references
+	ok = ok && padTo(f, pos, blocks[BinaryMeshBlock_IndexRanges].m_offset);
+	PrimitiveTypes::UInt32 firstSegment = 0;
+	for (PrimitiveTypes::UInt32 ir = 0; ok && ir < pIndices->m_indexRanges.m_size; ++ir)
+	{
+		IndexRange &range = pIndices->m_indexRanges[ir];
+		BinaryMeshIndexRange dst;
+		dst.m_start = range.m_start;
+		dst.m_end = range.m_end;
+		dst.m_minVertIndex = range.m_minVertIndex;
+		dst.m_maxVertIndex = range.m_maxVertIndex;
+		dst.m_firstBoneSegment = firstSegment;
+		dst.m_numBoneSegments = range.m_boneSegments.m_size;
+		firstSegment += dst.m_numBoneSegments;
+		ok = fwrite(&dst, sizeof(dst), 1, f) == 1;
+		pos += sizeof(dst);
+	}
+
+	ok = ok && padTo(f, pos, blocks[BinaryMeshBlock_BoneSegments].m_offset);
+	PrimitiveTypes::UInt32 firstBone = 0;
+	for (PrimitiveTypes::UInt32 ir = 0; ok && ir < pIndices->m_indexRanges.m_size; ++ir)
+	{
+		IndexRange &range = pIndices->m_indexRanges[ir];
+		for (PrimitiveTypes::UInt32 is = 0; ok && is < range.m_boneSegments.m_size; ++is)
+		{
+			IndexRange::BoneSegment &segment = range.m_boneSegments[is];
+			BinaryMeshBoneSegment dst;
+			dst.m_start = segment.m_start;
+			dst.m_end = segment.m_end;
+			dst.m_firstBone = firstBone;
+			dst.m_numBones = segment.m_boneSegmentBones.m_size;
+			firstBone += dst.m_numBones;
+			ok = fwrite(&dst, sizeof(dst), 1, f) == 1;
+			pos += sizeof(dst);
+		}
+	}
+
+	ok = ok && padTo(f, pos, blocks[BinaryMeshBlock_BoneSegmentBones].m_offset);
+	for (PrimitiveTypes::UInt32 ir = 0; ok && ir < pIndices->m_indexRanges.m_size; ++ir)
+	{
+		IndexRange &range = pIndices->m_indexRanges[ir];
+		for (PrimitiveTypes::UInt32 is = 0; ok && is < range.m_boneSegments.m_size; ++is)
+		{
+			IndexRange::BoneSegment &segment = range.m_boneSegments[is];
+			for (PrimitiveTypes::UInt32 ib = 0; ok && ib < segment.m_boneSegmentBones.m_size; ++ib)
+			{
+				const PrimitiveTypes::Int32 bone = (PrimitiveTypes::Int32)(segment.m_boneSegmentBones[ib]);
+				ok = fwrite(&bone, sizeof(bone), 1, f) == 1;
+				pos += sizeof(bone);
+			}
+		}
+	}
+
+	if (pWeights)
+	{
+		ok = ok && padTo(f, pos, blocks[BinaryMeshBlock_SkinWeightCounts].m_offset);
+		for (PrimitiveTypes::UInt32 iv = 0; ok && iv < header.m_numVertices; ++iv)
+		{
+			const PrimitiveTypes::UInt32 count = pWeights->m_weightsPerVertex[iv].m_size;
+			ok = fwrite(&count, sizeof(count), 1, f) == 1;
+			pos += sizeof(count);
+		}
+
+		ok = ok && padTo(f, pos, blocks[BinaryMeshBlock_SkinWeights].m_offset);
+		for (PrimitiveTypes::UInt32 iv = 0; ok && iv < header.m_numVertices; ++iv)
+		{
+			Array<WeightPair> &weights = pWeights->m_weightsPerVertex[iv];
+			for (PrimitiveTypes::UInt32 iw = 0; ok && iw < weights.m_size; ++iw)
+			{
+				BinaryMeshSkinWeight dst;
+				dst.m_jointIndex = weights[iw].m_jointIndex;
+				dst.m_weight = weights[iw].m_weight;
+				ok = fwrite(&dst, sizeof(dst), 1, f) == 1;
+				pos += sizeof(dst);
+			}
+		}
+	}
+	fclose(f);
+
+	PEASSERT(!ok || pos == header.m_fileSize, "Binary mesh size mismatch");
+	if (!ok)
+		remove(path);
+	return ok;
+}
+
+bool BinaryMesh::FindMaterialSetFile(const char *sourcePath, char *outName, int outSize)
+{
+	FILE *f = fopen(sourcePath, "rt");
+	if (!f)
+		return false;
+
+	// the material set is the line naming a file with the material set extension
+	const size_t extLength = strlen(PE_MATERIAL_SET_EXTENSION);
+	bool found = false;
+	char line[256];
+	while (!found && fgets(line, sizeof(line), f))
+	{
+		size_t length = strlen(line);
+		while (length && (line[length - 1] == '\n' || line[length - 1] == '\r' || line[length - 1] == ' ' || line[length - 1] == '\t'))
+			line[--length] = '\0';
+
+		found = length > extLength && length < (size_t)(outSize)
+			&& strcmp(line + length - extLength, PE_MATERIAL_SET_EXTENSION) == 0;
+		if (found)
+			strcpy(outName, line);
+	}
+	fclose(f);
+	return found;
+}
+
+bool BinaryMesh::Convert(PE::GameContext &context, PE::MemoryArena arena, const char *asset, const char *package, const char *materialSetFile)
+{
+	MeshCPU mcpu(context, arena);
+	mcpu.ReadMesh(asset, package, "");
+
+	char sourcePath[512];
+	PEString::generatePathname(context, asset, package, "Meshes", sourcePath, sizeof(sourcePath));
+
+	char foundMaterialSetFile[PE_BINARY_MESH_MAX_NAME];
+	if (!materialSetFile && FindMaterialSetFile(sourcePath, foundMaterialSetFile, sizeof(foundMaterialSetFile)))
+		materialSetFile = foundMaterialSetFile;
+
+	BakedSource source;
+	const bool ok = materialSetFile && MappedFile::GetSourceInfo(sourcePath, source) && Write(sourcePath, source, mcpu, materialSetFile);
+	PEINFO("BinaryMesh: %s %s\n", ok ? "wrote" : "failed to write", sourcePath);
+	return ok;
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,141 @@
+#ifndef __PYENGINE_2_0_BINARY_MESH_H__
+#define __PYENGINE_2_0_BINARY_MESH_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+
+// Sibling/Children includes
+#include "MappedFile.h"
+
+#define PE_BINARY_MESH_MAGIC 0x424d4550 // "PEMB"
+#define PE_BINARY_MESH_VERSION 2
+#define PE_BINARY_MESH_EXTENSION ".meshb"
+#define PE_BINARY_MESH_BLOCK_ALIGNMENT 16
+#define PE_BINARY_MESH_MAX_NAME 64
+#define PE_MATERIAL_SET_EXTENSION ".mseta" // how a .mesha names its material set
+
+namespace PE {
+struct MeshCPU;
+namespace Components {
+
+enum EBinaryMeshBlock
+{
+	BinaryMeshBlock_Positions,        // 3 Float32 per vertex
+	BinaryMeshBlock_Normals,          // 3 Float32 per vertex
+	BinaryMeshBlock_Tangents,         // 3 Float32 per vertex
+	BinaryMeshBlock_TexCoords,        // 2 Float32 per vertex
+	BinaryMeshBlock_Indices,          // UInt16
+	BinaryMeshBlock_IndexRanges,      // BinaryMeshIndexRange
+	BinaryMeshBlock_BoneSegments,     // BinaryMeshBoneSegment
+	BinaryMeshBlock_BoneSegmentBones, // Int32
+	BinaryMeshBlock_SkinWeightCounts, // UInt32 per vertex
+	BinaryMeshBlock_SkinWeights,      // BinaryMeshSkinWeight, SkinWeightCounts[i] for vertex i
+	BinaryMeshBlock_Count
+};
+
+// m_offset is from the start of the file and a multiple of PE_BINARY_MESH_BLOCK_ALIGNMENT. m_count == 0 for absent streams
+struct BinaryMeshBlock
+{
+	PrimitiveTypes::UInt32 m_offset;
+	PrimitiveTypes::UInt32 m_count;
+	PrimitiveTypes::UInt32 m_elementSize;
+	PrimitiveTypes::UInt32 m_padding;
+};
+
+struct BinaryMeshIndexRange
+{
+	PrimitiveTypes::UInt32 m_start, m_end;
+	PrimitiveTypes::UInt32 m_minVertIndex, m_maxVertIndex;
+	PrimitiveTypes::UInt32 m_firstBoneSegment, m_numBoneSegments;
+};
+
+struct BinaryMeshBoneSegment
+{
+	PrimitiveTypes::UInt32 m_start, m_end;
+	PrimitiveTypes::UInt32 m_firstBone, m_numBones;
+};
+
+struct BinaryMeshSkinWeight
+{
+	PrimitiveTypes::Int32 m_jointIndex;
+	PrimitiveTypes::Float32 m_weight;
+};
+
+struct BinaryMeshHeader
+{
+	PrimitiveTypes::UInt32 m_magic;
+	PrimitiveTypes::UInt32 m_version;
+	PrimitiveTypes::UInt32 m_fileSize;
+	PrimitiveTypes::UInt32 m_numVertices;
+
+	// source asset the binary was converted from
+	BakedSource m_source;
+
+	// IndexBufferCPU fields that are not per element
+	PrimitiveTypes::UInt32 m_primitiveTopology;
+	PrimitiveTypes::UInt32 m_verticesPerPolygon;
+	PrimitiveTypes::UInt32 m_minVertexIndex;
+	PrimitiveTypes::UInt32 m_maxVertexIndex;
+
+	// material set file, still read through MaterialSetCPU
+	char m_materialSetFile[PE_BINARY_MESH_MAX_NAME];
+
+	BinaryMeshBlock m_blocks[BinaryMeshBlock_Count];
+};
+
+// Versioned binary mesh container: a header and aligned blocks in the layout of the MeshCPU buffers,
+// mapped at load instead of parsing text. Vertex and index streams are one memcpy each; index ranges,
+// bone segments and skin weights still allocate one Array per range, segment or vertex, as MeshCPU holds them.
+// Written next to the .mesha (<file>.mesha.meshb) by Convert() or by MeshManager the first time it parses
+// the text, and used while the source size, time or hash match (MappedFile::openBaked).
+struct BinaryMesh
+{
+	BinaryMesh();
+
+	static void MakePath(const char *sourcePath, char *outPath, int outSize);
+
+	// Maps and validates the binary mesh of sourcePath. false when missing, stale or malformed
+	bool open(const char *sourcePath);
+	void close();
+
+	// Creates the CPU buffers of mcpu from the mapped blocks, ready for Mesh::loadFromMeshCPU_needsRC
+	void fillMeshCPU(PE::GameContext &context, PE::MemoryArena arena, MeshCPU &mcpu, const char *package) const;
+
+	// Only the vertex streams (positions, and normals, tangents, tex coords when present), e.g. to reload
+	// buffers a Mesh has released (MeshCpuResidency)
+	void fillVertexBuffers(PE::GameContext &context, PE::MemoryArena arena,
+		Handle &hPositions, Handle &hNormals, Handle &hTangents, Handle &hTexCoords) const;
+
+	// Writes the binary mesh of sourcePath from a MeshCPU read from text; source is from MappedFile::GetSourceInfo
+	static bool Write(const char *sourcePath, const BakedSource &source, MeshCPU &mcpu, const char *materialSetFile);
+
+	// Material set file named by the .mesha text, which Write() needs. false when there is none
+	static bool FindMaterialSetFile(const char *sourcePath, char *outName, int outSize);
+
+	// Converter: reads the .mesha through MeshCPU::ReadMesh and writes its binary next to it.
+	// materialSetFile may be NULL to take it from the .mesha
+	static bool Convert(PE::GameContext &context, PE::MemoryArena arena, const char *asset, const char *package, const char *materialSetFile);
+
+	const BinaryMeshHeader &getHeader() const { return *m_pHeader; }
+
+	template <typename T>
+	const T *getBlock(EBinaryMeshBlock block) const
+	{
+		return (const T *)((const char *)(m_pHeader) + m_pHeader->m_blocks[block].m_offset);
+	}
+
+private:
+	MappedFile m_file;
+	const BinaryMeshHeader *m_pHeader;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
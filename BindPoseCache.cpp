@@ -0,0 +1,72 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "BindPoseCache.h"
+
+namespace PE {
+namespace Components {
+
+// Static member variables
+BindPoseCache *BindPoseCache::s_pInstance = NULL;
+Handle BindPoseCache::s_hInstance;
+
+BindPose::BindPose(PE::GameContext &context, PE::MemoryArena arena,
+	const Matrix4x4 *pModelSpacePalette, const Matrix4x4 *pSkinPalette, int numJoints)
+: m_modelSpacePalette(context, arena)
+, m_skinPalette(context, arena)
+, m_numJoints(numJoints)
+{
+	m_modelSpacePalette.reset(numJoints);
+	m_skinPalette.reset(numJoints);
+	m_modelSpacePalette.m_size = m_skinPalette.m_size = numJoints;
+	memcpy(m_modelSpacePalette.getFirstPtr(), pModelSpacePalette, sizeof(Matrix4x4) * numJoints);
+	memcpy(m_skinPalette.getFirstPtr(), pSkinPalette, sizeof(Matrix4x4) * numJoints);
+}
+
+void BindPoseCache::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle handle("BIND_POSE_CACHE", sizeof(BindPoseCache));
+	s_pInstance = new(handle) BindPoseCache(context, arena);
+	s_hInstance = handle;
+}
+
+BindPoseCache::BindPoseCache(PE::GameContext &context, PE::MemoryArena arena)
+: m_numEntries(0)
+, m_pContext(&context)
+, m_arena(arena)
+{
+	memset(m_skeletonAssetHashes, 0, sizeof(m_skeletonAssetHashes));
+}
+
+const BindPose *BindPoseCache::find(PrimitiveTypes::UInt64 skeletonAssetHash) const
+{
+	for (int i = 0; i < m_numEntries; ++i)
+	{
+		if (m_skeletonAssetHashes[i] == skeletonAssetHash)
+			return m_hBindPoses[i].getObject<BindPose>();
+	}
+	return NULL;
+}
+
+const BindPose *BindPoseCache::add(PrimitiveTypes::UInt64 skeletonAssetHash, const Matrix4x4 *pModelSpacePalette, const Matrix4x4 *pSkinPalette, int numJoints)
+{
+	if (isFull())
+		return NULL;
+
+	Handle hBindPose("BIND_POSE", sizeof(BindPose));
+	BindPose *pBindPose = new(hBindPose) BindPose(*m_pContext, m_arena, pModelSpacePalette, pSkinPalette, numJoints);
+
+	m_skeletonAssetHashes[m_numEntries] = skeletonAssetHash;
+	m_hBindPoses[m_numEntries] = hBindPose;
+	++m_numEntries;
+	return pBindPose;
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,66 @@
+#ifndef __PYENGINE_2_0_BIND_POSE_CACHE_H__
+#define __PYENGINE_2_0_BIND_POSE_CACHE_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+
+// Sibling/Children includes
+
+#define PE_BIND_POSE_CACHE_MAX_SKELETONS 32
+
+namespace PE {
+namespace Components {
+
+// Bind pose palettes of one skeleton: model space (skin scale applied) and after applyInverses
+struct BindPose
+{
+	BindPose(PE::GameContext &context, PE::MemoryArena arena,
+		const Matrix4x4 *pModelSpacePalette, const Matrix4x4 *pSkinPalette, int numJoints);
+
+	Array<Matrix4x4> m_modelSpacePalette;
+	Array<Matrix4x4> m_skinPalette;
+	int m_numJoints;
+};
+
+// Bind pose of every Skeleton asset, computed once and copied by all instances without active slots.
+// Keyed by the skeleton's AssetId hash, which stays valid for as long as MeshManager keeps the asset.
+// Entries are added serially (Event_CALCULATE_TRANSFORMATIONS) and only read by palette jobs
+struct BindPoseCache
+{
+	BindPoseCache(PE::GameContext &context, PE::MemoryArena arena);
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static BindPoseCache *Instance() { return s_pInstance; }
+
+	const BindPose *find(PrimitiveTypes::UInt64 skeletonAssetHash) const;
+
+	// returns NULL when the cache is full; such skeletons keep evaluating their own bind pose
+	const BindPose *add(PrimitiveTypes::UInt64 skeletonAssetHash, const Matrix4x4 *pModelSpacePalette, const Matrix4x4 *pSkinPalette, int numJoints);
+
+	bool isFull() const { return m_numEntries == PE_BIND_POSE_CACHE_MAX_SKELETONS; }
+
+	// Data --------------------------------------------------------------------
+	PrimitiveTypes::UInt64 m_skeletonAssetHashes[PE_BIND_POSE_CACHE_MAX_SKELETONS];
+	Handle m_hBindPoses[PE_BIND_POSE_CACHE_MAX_SKELETONS];
+	int m_numEntries;
+
+	PE::GameContext *m_pContext;
+	PE::MemoryArena m_arena;
+
+	static BindPoseCache *s_pInstance;
+	static Handle s_hInstance;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
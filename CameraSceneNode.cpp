@@ -1,6 +1,7 @@
 #include "CameraSceneNode.h"
 #include "../Lua/LuaEnvironment.h"
 #include "PrimeEngine/Events/StandardEvents.h"
+#include "FrustumCulling.h"
 
 #define Z_ONLY_CAM_BIAS 0.0f
 namespace PE {
@@ -13,6 +14,7 @@ CameraSceneNode::CameraSceneNode(PE::GameContext &context, PE::MemoryArena arena
 {
 	m_near = 0.05f;
 	m_far = 2000.0f;
+	m_verticalFov = 0.33f * PrimitiveTypes::Constants::c_Pi_F32;
 }
 
 void CameraSceneNode::addDefaultComponents()
@@ -60,6 +62,7 @@ void CameraSceneNode::do_CALCULATE_TRANSFORMATIONS(Events::Event *pEvt)
 		static PrimitiveTypes::Float32 factor = 0.5f;
 		verticalFov *= factor;
 	}
+	m_verticalFov = verticalFov;
 
 	m_viewToProjectedTransform = CameraOps::CreateProjectionMatrix(
 		verticalFov, aspect, m_near, m_far);
@@ -79,30 +82,7 @@ void CameraSceneNode::do_CALCULATE_TRANSFORMATIONS(Events::Event *pEvt)
 
 	// Matrix4x4 mvp = m_viewToProjectedTransform * m_worldToViewTransform;  // this is normal version
 	Matrix4x4 mvp = m_viewToProjectedTransform * m_worldToViewTransform;  // objects disappear within camera view
-	mvp = mvp.transpose();
-
-	Vector3 m1j = mvp.getU();    // m11, m12, m13
-	Vector3 m2j = mvp.getV();    // m21, m22, m23
-	Vector3 m3j = mvp.getN();    // m31, m32, m33
-	Vector3 m4j = mvp.getPos();  // m41, m42, m43
-
-	// Left clipping plane
-	m_frustumPlanes[0].buildPlaneByPlus(m4j, m1j, mvp.m[3][3], mvp.m[3][0]);
-
-	// Right clipping plane
-	m_frustumPlanes[1].buildPlaneByMinus(m4j, m1j, mvp.m[3][3], mvp.m[3][0]);
-
-	// Top clipping plane
-	m_frustumPlanes[2].buildPlaneByMinus(m4j, m2j, mvp.m[3][3], mvp.m[3][1]);
-
-	// Bottom clipping plane
-	m_frustumPlanes[3].buildPlaneByPlus(m4j, m2j, mvp.m[3][3], mvp.m[3][1]);
-
-	// Near clipping plane
-	m_frustumPlanes[4].buildPlaneByPlus(m4j, m3j, mvp.m[3][3], mvp.m[3][2]);
-
-	// Far clipping plane
-	m_frustumPlanes[5].buildPlaneByMinus(m4j, m3j, mvp.m[3][3], mvp.m[3][2]);
+	MultiViewCuller::buildFrustumPlanes(mvp, m_frustumPlanes);
 }
 
 }; // namespace Components
@@ -41,6 +41,7 @@ struct CameraSceneNode : public SceneNode
 	Matrix4x4 m_worldToViewTransform2;
 	Matrix4x4 m_viewToProjectedTransform; // view -> clip (projection)
 	float m_near, m_far;
+	float m_verticalFov; // radians, as used for m_viewToProjectedTransform
 
 	Plane m_frustumPlanes[6];
 };
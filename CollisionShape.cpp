@@ -0,0 +1,28 @@
+#include "CollisionShape.h"
+
+namespace PE {
+namespace Components {
+
+CollisionShape::CollisionShape(float minX, float maxX, float minY, float maxY, float minZ, float maxZ)
+{
+	build(minX, maxX, minY, maxY, minZ, maxZ);
+}
+
+void CollisionShape::build(float minX, float maxX, float minY, float maxY, float minZ, float maxZ)
+{
+	// Assemble the 8 local-space corners of the box
+	// lower ring
+	m_vertices[0] = Vector3(minX, minY, minZ);
+	m_vertices[1] = Vector3(minX, minY, maxZ);
+	m_vertices[2] = Vector3(maxX, minY, minZ);
+	m_vertices[3] = Vector3(maxX, minY, maxZ);
+
+	// upper ring
+	m_vertices[4] = Vector3(minX, maxY, minZ);
+	m_vertices[5] = Vector3(minX, maxY, maxZ);
+	m_vertices[6] = Vector3(maxX, maxY, minZ);
+	m_vertices[7] = Vector3(maxX, maxY, maxZ);
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,26 @@
+#ifndef _CHARACTER_CONTROL_COLLISION_SHAPE_
+#define _CHARACTER_CONTROL_COLLISION_SHAPE_
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Math/Vector3.h"
+
+namespace PE {
+namespace Components {
+
+// Local space box of a Mesh, built once at load and shared by the PhysicsManagers of all its instances.
+// Instances only keep the world space data derived from it
+struct CollisionShape
+{
+	CollisionShape(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
+
+	void build(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
+
+	// Data -------------------------------------------------------------------
+	Vector3 m_vertices[8]; // lower ring x-z-, x-z+, x+z-, x+z+, then the upper ring
+};
+
+}; // namespace Components
+}; // namespace PE
+#endif
@@ -0,0 +1,113 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <float.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "CollisionSidecar.h"
+#include "SkinJointBounds.h"
+
+namespace PE {
+namespace Components {
+
+CollisionSidecar::CollisionSidecar()
+: m_pHeader(NULL)
+{
+}
+
+void CollisionSidecar::MakePath(const char *sourcePath, char *outPath, int outSize)
+{
+	snprintf(outPath, outSize, "%s%s", sourcePath, PE_COLLISION_SIDECAR_EXTENSION);
+}
+
+bool CollisionSidecar::open(const char *sourcePath)
+{
+	close();
+
+	char path[512];
+	MakePath(sourcePath, path, sizeof(path));
+	if (!m_file.openBaked(path, sourcePath, PE_COLLISION_SIDECAR_MAGIC, PE_COLLISION_SIDECAR_VERSION,
+		sizeof(CollisionSidecarHeader), offsetof(CollisionSidecarHeader, m_source)))
+		return false;
+
+	const CollisionSidecarHeader *pHeader = (const CollisionSidecarHeader *)(m_file.getData());
+	if (pHeader->m_fileSize != sizeof(CollisionSidecarHeader) + pHeader->m_numJoints * 6 * sizeof(PrimitiveTypes::Float32))
+	{
+		m_file.close();
+		return false;
+	}
+
+	m_pHeader = pHeader;
+	return true;
+}
+
+void CollisionSidecar::close()
+{
+	m_pHeader = NULL;
+	m_file.close();
+}
+
+void CollisionSidecar::getLocalBounds(Vector3 &outMin, Vector3 &outMax) const
+{
+	outMin = Vector3(m_pHeader->m_localMin[0], m_pHeader->m_localMin[1], m_pHeader->m_localMin[2]);
+	outMax = Vector3(m_pHeader->m_localMax[0], m_pHeader->m_localMax[1], m_pHeader->m_localMax[2]);
+}
+
+bool CollisionSidecar::Bake(const char *sourcePath, const BakedSource &source, const PrimitiveTypes::Float32 *pPositions, int numVertices,
+	const SkinJointBounds *pJointBounds)
+{
+	CollisionSidecarHeader header;
+	memset(&header, 0, sizeof(header));
+	header.m_magic = PE_COLLISION_SIDECAR_MAGIC;
+	header.m_version = PE_COLLISION_SIDECAR_VERSION;
+	header.m_numVertices = numVertices;
+	header.m_numJoints = pJointBounds ? pJointBounds->m_jointMin.m_size : 0;
+	header.m_fileSize = sizeof(CollisionSidecarHeader) + header.m_numJoints * 6 * sizeof(PrimitiveTypes::Float32);
+	header.m_source = source;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		header.m_localMin[i] = FLT_MAX;
+		header.m_localMax[i] = -FLT_MAX;
+	}
+	for (int iv = 0; iv < numVertices; ++iv)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			const PrimitiveTypes::Float32 v = pPositions[iv * 3 + i];
+			header.m_localMin[i] = v < header.m_localMin[i] ? v : header.m_localMin[i];
+			header.m_localMax[i] = v > header.m_localMax[i] ? v : header.m_localMax[i];
+		}
+	}
+
+	char path[512];
+	MakePath(sourcePath, path, sizeof(path));
+	FILE *f = fopen(path, "wb");
+	if (!f)
+		return false;
+
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	for (PrimitiveTypes::UInt32 j = 0; ok && j < header.m_numJoints; ++j)
+	{
+		const Vector3 &mn = pJointBounds->m_jointMin[j];
+		const Vector3 &mx = pJointBounds->m_jointMax[j];
+		const PrimitiveTypes::Float32 box[6] = {mn.m_x, mn.m_y, mn.m_z, mx.m_x, mx.m_y, mx.m_z};
+		ok = fwrite(box, sizeof(box), 1, f) == 1;
+	}
+	fclose(f);
+
+	// a partial file would be rejected by its size anyway, but do not leave it around
+	if (!ok)
+		remove(path);
+	return ok;
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,74 @@
+#ifndef __PYENGINE_2_0_COLLISION_SIDECAR_H__
+#define __PYENGINE_2_0_COLLISION_SIDECAR_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Vector3.h"
+
+// Sibling/Children includes
+#include "MappedFile.h"
+
+#define PE_COLLISION_SIDECAR_MAGIC 0x53434550 // "PECS"
+#define PE_COLLISION_SIDECAR_VERSION 2
+#define PE_COLLISION_SIDECAR_EXTENSION ".col"
+
+namespace PE {
+namespace Components {
+
+struct SkinJointBounds;
+
+// File layout: header, then m_numJoints boxes of 6 floats (min xyz, max xyz; min > max for joints without vertices)
+struct CollisionSidecarHeader
+{
+	PrimitiveTypes::UInt32 m_magic;
+	PrimitiveTypes::UInt32 m_version;
+	PrimitiveTypes::UInt32 m_fileSize;
+	PrimitiveTypes::UInt32 m_numJoints;
+
+	// source asset the sidecar was baked from
+	BakedSource m_source;
+
+	PrimitiveTypes::Float32 m_localMin[3];
+	PrimitiveTypes::Float32 m_localMax[3];
+
+	PrimitiveTypes::UInt32 m_numVertices;
+	PrimitiveTypes::UInt32 m_padding;
+};
+
+// Collision data baked next to a .mesha on first load, so later loads map it instead of scanning vertices.
+// A sidecar is used while its source size, time or hash match (MappedFile::openBaked).
+struct CollisionSidecar
+{
+	CollisionSidecar();
+
+	static void MakePath(const char *sourcePath, char *outPath, int outSize);
+
+	// Maps and validates the sidecar of sourcePath. false when missing, stale or malformed
+	bool open(const char *sourcePath);
+	void close();
+
+	// Computes and writes the sidecar of sourcePath from loaded positions (3 floats per vertex).
+	// source is from MappedFile::GetSourceInfo; pJointBounds may be NULL for static meshes
+	static bool Bake(const char *sourcePath, const BakedSource &source, const PrimitiveTypes::Float32 *pPositions, int numVertices,
+		const SkinJointBounds *pJointBounds);
+
+	const CollisionSidecarHeader &getHeader() const { return *m_pHeader; }
+	const PrimitiveTypes::Float32 *getJointBoxes() const { return (const PrimitiveTypes::Float32 *)(m_pHeader + 1); }
+
+	void getLocalBounds(Vector3 &outMin, Vector3 &outMax) const;
+
+private:
+	MappedFile m_file;
+	const CollisionSidecarHeader *m_pHeader;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
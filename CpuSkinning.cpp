@@ -0,0 +1,338 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+#include <math.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Geometry/MeshCPU/MeshCPU.h"
+
+// Sibling/Children includes
+#include "CpuSkinning.h"
+#include "JobPool.h"
+#include "Mesh.h"
+#include "MeshCpuResidency.h"
+
+// the SSE switch is defined by the header above
+#if PE_CPU_SKINNING_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace PE {
+namespace Components {
+
+SkinningStreams::SkinningStreams(PE::GameContext &context, PE::MemoryArena arena)
+: m_numVertices(0)
+, m_positions(context, arena)
+, m_normals(context, arena)
+, m_tangents(context, arena)
+, m_jointIndices(context, arena)
+, m_weights(context, arena)
+, m_numDroppedInfluences(0)
+{
+}
+
+PrimitiveTypes::UInt32 SkinningStreams::clear()
+{
+	const PrimitiveTypes::UInt32 bytes = (m_positions.m_size + m_normals.m_size + m_tangents.m_size + m_weights.m_size) * sizeof(PrimitiveTypes::Float32)
+		+ m_jointIndices.m_size * sizeof(PrimitiveTypes::UInt16);
+	m_positions.reset(0);
+	m_normals.reset(0);
+	m_tangents.reset(0);
+	m_jointIndices.reset(0);
+	m_weights.reset(0);
+	m_numVertices = 0;
+	return bytes;
+}
+
+// xyz source, 4 floats per vertex with the given w
+static void padVectors(Array<PrimitiveTypes::Float32> &dst, const PrimitiveTypes::Float32 *pSrc, int numVertices, PrimitiveTypes::Float32 w)
+{
+	dst.reset(numVertices * 4);
+	dst.m_size = numVertices * 4;
+	for (int i = 0; i < numVertices; ++i)
+	{
+		dst[i * 4 + 0] = pSrc[i * 3 + 0];
+		dst[i * 4 + 1] = pSrc[i * 3 + 1];
+		dst[i * 4 + 2] = pSrc[i * 3 + 2];
+		dst[i * 4 + 3] = w;
+	}
+}
+
+void SkinningStreams::build(PositionBufferCPU *pPositions, NormalBufferCPU *pNormals, TangentBufferCPU *pTangents, SkinWeightsCPU *pWeights)
+{
+	m_numVertices = pPositions->m_values.m_size / 3;
+	PEASSERT(m_numVertices <= (int)(pWeights->m_weightsPerVertex.m_size), "Skin weights do not cover the position buffer");
+
+	padVectors(m_positions, pPositions->m_values.getFirstPtr(), m_numVertices, 1.0f);
+	if (pNormals && (int)(pNormals->m_values.m_size) >= m_numVertices * 3)
+		padVectors(m_normals, pNormals->m_values.getFirstPtr(), m_numVertices, 0.0f);
+	if (pTangents && (int)(pTangents->m_values.m_size) >= m_numVertices * 3)
+		padVectors(m_tangents, pTangents->m_values.getFirstPtr(), m_numVertices, 0.0f);
+
+	m_jointIndices.reset(m_numVertices * PE_CPU_SKINNING_MAX_INFLUENCES);
+	m_weights.reset(m_numVertices * PE_CPU_SKINNING_MAX_INFLUENCES);
+	m_jointIndices.m_size = m_weights.m_size = m_numVertices * PE_CPU_SKINNING_MAX_INFLUENCES;
+	m_numDroppedInfluences = 0;
+
+	for (int i = 0; i < m_numVertices; ++i)
+	{
+		PrimitiveTypes::UInt16 *pJoints = &m_jointIndices[i * PE_CPU_SKINNING_MAX_INFLUENCES];
+		PrimitiveTypes::Float32 *pW = &m_weights[i * PE_CPU_SKINNING_MAX_INFLUENCES];
+		for (int k = 0; k < PE_CPU_SKINNING_MAX_INFLUENCES; ++k)
+		{
+			pJoints[k] = 0;
+			pW[k] = 0.0f;
+		}
+
+		// keep the strongest influences, sorted by insertion
+		Array<WeightPair> &weights = pWeights->m_weightsPerVertex[i];
+		for (int iw = 0; iw < weights.m_size; ++iw)
+		{
+			const WeightPair &wp = weights[iw];
+			if (wp.m_weight <= 0.0f)
+				continue;
+
+			if (pW[PE_CPU_SKINNING_MAX_INFLUENCES - 1] > 0.0f)
+				++m_numDroppedInfluences;
+			if (wp.m_weight <= pW[PE_CPU_SKINNING_MAX_INFLUENCES - 1])
+				continue;
+
+			int k = PE_CPU_SKINNING_MAX_INFLUENCES - 1;
+			while (k > 0 && pW[k - 1] < wp.m_weight)
+			{
+				pW[k] = pW[k - 1];
+				pJoints[k] = pJoints[k - 1];
+				--k;
+			}
+			pW[k] = wp.m_weight;
+			pJoints[k] = (PrimitiveTypes::UInt16)(wp.m_jointIndex);
+		}
+
+		PrimitiveTypes::Float32 sum = 0.0f;
+		for (int k = 0; k < PE_CPU_SKINNING_MAX_INFLUENCES; ++k)
+			sum += pW[k];
+		if (sum > 0.0f)
+		{
+			for (int k = 0; k < PE_CPU_SKINNING_MAX_INFLUENCES; ++k)
+				pW[k] /= sum;
+		}
+	}
+}
+
+// Skinning matrices as 4 columns of 4 floats (w = 0) so a weighted blend is 16 multiply-adds per vertex
+// and transforming a vector is 3-4 more
+static void buildColumns(const Matrix4x4 *pSkinPalette, int numJoints, PrimitiveTypes::Float32 *pColumns)
+{
+	for (int j = 0; j < numJoints; ++j)
+	{
+		const Matrix4x4 &m = pSkinPalette[j];
+		PrimitiveTypes::Float32 *c = &pColumns[j * 16];
+		for (int col = 0; col < 4; ++col)
+		{
+			c[col * 4 + 0] = m.m[0][col];
+			c[col * 4 + 1] = m.m[1][col];
+			c[col * 4 + 2] = m.m[2][col];
+			c[col * 4 + 3] = 0.0f;
+		}
+	}
+}
+
+static inline void store3(PrimitiveTypes::Float32 *pDst, const PrimitiveTypes::Float32 *pSrc4)
+{
+	pDst[0] = pSrc4[0];
+	pDst[1] = pSrc4[1];
+	pDst[2] = pSrc4[2];
+}
+
+static void skinVertices(const SkinningStreams &streams, const PrimitiveTypes::Float32 *pColumns, int numJoints, int begin, int end,
+	PrimitiveTypes::Float32 *pOutPositions, PrimitiveTypes::Float32 *pOutNormals, PrimitiveTypes::Float32 *pOutTangents)
+{
+	const bool doNormals = pOutNormals && streams.m_normals.m_size;
+	const bool doTangents = pOutTangents && streams.m_tangents.m_size;
+
+	for (int i = begin; i < end; ++i)
+	{
+		const PrimitiveTypes::UInt16 *pJoints = &streams.m_jointIndices[i * PE_CPU_SKINNING_MAX_INFLUENCES];
+		const PrimitiveTypes::Float32 *pW = &streams.m_weights[i * PE_CPU_SKINNING_MAX_INFLUENCES];
+#if PE_CPU_SKINNING_USE_SSE
+		__m128 b0 = _mm_setzero_ps(), b1 = _mm_setzero_ps(), b2 = _mm_setzero_ps(), b3 = _mm_setzero_ps();
+		for (int k = 0; k < PE_CPU_SKINNING_MAX_INFLUENCES; ++k)
+		{
+			const int j = pJoints[k] < numJoints ? pJoints[k] : 0;
+			const PrimitiveTypes::Float32 *c = &pColumns[j * 16];
+			const __m128 w = _mm_set1_ps(pW[k]);
+			b0 = _mm_add_ps(b0, _mm_mul_ps(_mm_load_ps(c + 0), w));
+			b1 = _mm_add_ps(b1, _mm_mul_ps(_mm_load_ps(c + 4), w));
+			b2 = _mm_add_ps(b2, _mm_mul_ps(_mm_load_ps(c + 8), w));
+			b3 = _mm_add_ps(b3, _mm_mul_ps(_mm_load_ps(c + 12), w));
+		}
+
+		alignas(16) PrimitiveTypes::Float32 out[4];
+		if (pOutPositions)
+		{
+			const PrimitiveTypes::Float32 *p = &streams.m_positions[i * 4];
+			const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, _mm_set1_ps(p[0])), _mm_mul_ps(b1, _mm_set1_ps(p[1]))),
+				_mm_add_ps(_mm_mul_ps(b2, _mm_set1_ps(p[2])), b3));
+			_mm_store_ps(out, r);
+			store3(&pOutPositions[i * 3], out);
+		}
+		if (doNormals)
+		{
+			const PrimitiveTypes::Float32 *n = &streams.m_normals[i * 4];
+			const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, _mm_set1_ps(n[0])), _mm_mul_ps(b1, _mm_set1_ps(n[1]))),
+				_mm_mul_ps(b2, _mm_set1_ps(n[2])));
+			_mm_store_ps(out, r);
+			store3(&pOutNormals[i * 3], out);
+		}
+		if (doTangents)
+		{
+			const PrimitiveTypes::Float32 *t = &streams.m_tangents[i * 4];
+			const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, _mm_set1_ps(t[0])), _mm_mul_ps(b1, _mm_set1_ps(t[1]))),
+				_mm_mul_ps(b2, _mm_set1_ps(t[2])));
+			_mm_store_ps(out, r);
+			store3(&pOutTangents[i * 3], out);
+		}
+#else
+		PrimitiveTypes::Float32 b[16];
+		memset(b, 0, sizeof(b));
+		for (int k = 0; k < PE_CPU_SKINNING_MAX_INFLUENCES; ++k)
+		{
+			const int j = pJoints[k] < numJoints ? pJoints[k] : 0;
+			const PrimitiveTypes::Float32 *c = &pColumns[j * 16];
+			for (int e = 0; e < 16; ++e)
+				b[e] += c[e] * pW[k];
+		}
+
+		PrimitiveTypes::Float32 out[4];
+		if (pOutPositions)
+		{
+			const PrimitiveTypes::Float32 *p = &streams.m_positions[i * 4];
+			for (int e = 0; e < 3; ++e)
+				out[e] = b[e] * p[0] + b[4 + e] * p[1] + b[8 + e] * p[2] + b[12 + e];
+			store3(&pOutPositions[i * 3], out);
+		}
+		if (doNormals)
+		{
+			const PrimitiveTypes::Float32 *n = &streams.m_normals[i * 4];
+			for (int e = 0; e < 3; ++e)
+				out[e] = b[e] * n[0] + b[4 + e] * n[1] + b[8 + e] * n[2];
+			store3(&pOutNormals[i * 3], out);
+		}
+		if (doTangents)
+		{
+			const PrimitiveTypes::Float32 *t = &streams.m_tangents[i * 4];
+			for (int e = 0; e < 3; ++e)
+				out[e] = b[e] * t[0] + b[4 + e] * t[1] + b[8 + e] * t[2];
+			store3(&pOutTangents[i * 3], out);
+		}
+#endif
+	}
+}
+
+struct CpuSkinningJob
+{
+	const SkinningStreams *m_pStreams;
+	const PrimitiveTypes::Float32 *m_pColumns;
+	int m_numJoints;
+	PrimitiveTypes::Float32 *m_pOutPositions;
+	PrimitiveTypes::Float32 *m_pOutNormals;
+	PrimitiveTypes::Float32 *m_pOutTangents;
+};
+
+static void skinJobRange(void *pUserData, int begin, int end)
+{
+	const CpuSkinningJob *pJob = (const CpuSkinningJob *)(pUserData);
+	skinVertices(*pJob->m_pStreams, pJob->m_pColumns, pJob->m_numJoints, begin, end,
+		pJob->m_pOutPositions, pJob->m_pOutNormals, pJob->m_pOutTangents);
+}
+
+void CpuSkinning::skin(const SkinningStreams &streams, const Matrix4x4 *pSkinPalette, int numJoints,
+	PrimitiveTypes::Float32 *pOutPositions, PrimitiveTypes::Float32 *pOutNormals, PrimitiveTypes::Float32 *pOutTangents)
+{
+	PEASSERT(numJoints > 0 && numJoints <= PE_CPU_SKINNING_MAX_JOINTS, "Too many joints for CPU skinning");
+
+	// converted once, shared by all vertex ranges
+	alignas(16) PrimitiveTypes::Float32 columns[PE_CPU_SKINNING_MAX_JOINTS * 16];
+	buildColumns(pSkinPalette, numJoints, columns);
+
+	CpuSkinningJob job;
+	job.m_pStreams = &streams;
+	job.m_pColumns = columns;
+	job.m_numJoints = numJoints;
+	job.m_pOutPositions = pOutPositions;
+	job.m_pOutNormals = pOutNormals;
+	job.m_pOutTangents = pOutTangents;
+
+	JobPool::Instance()->parallelFor(streams.m_numVertices, PE_CPU_SKINNING_GRAIN_SIZE, &skinJobRange, &job);
+}
+
+void CpuSkinning::skinRange(const SkinningStreams &streams, const Matrix4x4 *pSkinPalette, int numJoints, int begin, int end,
+	PrimitiveTypes::Float32 *pOutPositions, PrimitiveTypes::Float32 *pOutNormals, PrimitiveTypes::Float32 *pOutTangents)
+{
+	PEASSERT(numJoints > 0 && numJoints <= PE_CPU_SKINNING_MAX_JOINTS, "Too many joints for CPU skinning");
+
+	alignas(16) PrimitiveTypes::Float32 columns[PE_CPU_SKINNING_MAX_JOINTS * 16];
+	buildColumns(pSkinPalette, numJoints, columns);
+	skinVertices(streams, columns, numJoints, begin, end > streams.m_numVertices ? streams.m_numVertices : end,
+		pOutPositions, pOutNormals, pOutTangents);
+}
+
+SkinningStreams *CpuSkinning::AcquireStreams(PE::GameContext &context, PE::MemoryArena arena, Mesh *pMesh)
+{
+	if (pMesh->m_hSkinningStreams.isValid())
+		return pMesh->m_hSkinningStreams.getObject<SkinningStreams>();
+
+	if (!pMesh->m_hSkinWeightsCPU.isValid() || !MeshCpuResidency::Acquire(pMesh))
+		return NULL;
+
+	PE::Handle hStreams("SkinningStreams", sizeof(SkinningStreams));
+	SkinningStreams *pStreams = new(hStreams) SkinningStreams(context, arena);
+	pStreams->build(pMesh->m_hPositionBufferCPU.getObject<PositionBufferCPU>(),
+		pMesh->m_hNormalBufferCPU.isValid() ? pMesh->m_hNormalBufferCPU.getObject<NormalBufferCPU>() : NULL,
+		pMesh->m_hTangentBufferCPU.isValid() ? pMesh->m_hTangentBufferCPU.getObject<TangentBufferCPU>() : NULL,
+		pMesh->m_hSkinWeightsCPU.getObject<SkinWeightsCPU>());
+	pMesh->m_hSkinningStreams = hStreams;
+	return pStreams;
+}
+
+PrimitiveTypes::Float32 CpuSkinning::maxReferenceError(const SkinningStreams &streams, const Matrix4x4 *pSkinPalette, int numJoints,
+	PositionBufferCPU *pPositions, SkinWeightsCPU *pWeights, const PrimitiveTypes::Float32 *pSkinnedPositions)
+{
+	PrimitiveTypes::Float32 maxError = 0.0f;
+	for (int i = 0; i < streams.m_numVertices; ++i)
+	{
+		Array<WeightPair> &weights = pWeights->m_weightsPerVertex[i];
+		if (weights.m_size > PE_CPU_SKINNING_MAX_INFLUENCES)
+			continue;
+
+		const Vector3 pos(pPositions->m_values[i * 3], pPositions->m_values[i * 3 + 1], pPositions->m_values[i * 3 + 2]);
+		Vector3 res(0, 0, 0);
+		PrimitiveTypes::Float32 weightSum = 0.0f;
+		for (int iw = 0; iw < weights.m_size; ++iw)
+		{
+			const WeightPair &w = weights[iw];
+			if (w.m_weight <= 0.0f || w.m_jointIndex >= numJoints)
+				continue;
+			res = res + (pSkinPalette[w.m_jointIndex] * pos) * w.m_weight;
+			weightSum += w.m_weight;
+		}
+		if (weightSum <= 0.0f)
+			continue;
+		res = res * (1.0f / weightSum); // the streams renormalize the weights
+
+		const PrimitiveTypes::Float32 *p = &pSkinnedPositions[i * 3];
+		const PrimitiveTypes::Float32 dx = fabsf(res.m_x - p[0]);
+		const PrimitiveTypes::Float32 dy = fabsf(res.m_y - p[1]);
+		const PrimitiveTypes::Float32 dz = fabsf(res.m_z - p[2]);
+		const PrimitiveTypes::Float32 d = dx > dy ? (dx > dz ? dx : dz) : (dy > dz ? dy : dz);
+		if (d > maxError)
+			maxError = d;
+	}
+	return maxError;
+}
+
+}; // namespace Components
+}; // namespace PE
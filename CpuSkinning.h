@@ -0,0 +1,83 @@
+#ifndef __PYENGINE_2_0_CPU_SKINNING_H__
+#define __PYENGINE_2_0_CPU_SKINNING_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+
+// Sibling/Children includes
+#include "PoseBounds.h" // PE_POSE_BOUNDS_USE_SSE
+
+#define PE_CPU_SKINNING_USE_SSE PE_POSE_BOUNDS_USE_SSE
+#define PE_CPU_SKINNING_MAX_INFLUENCES 4
+#define PE_CPU_SKINNING_MAX_JOINTS 256
+#define PE_CPU_SKINNING_GRAIN_SIZE 512 // vertices per job pool chunk
+
+namespace PE {
+struct PositionBufferCPU;
+struct NormalBufferCPU;
+struct TangentBufferCPU;
+struct SkinWeightsCPU;
+namespace Components {
+
+struct Mesh;
+
+// Skinned mesh data in the layout the skinning loop reads, built per skinned Mesh on first use.
+// Every vertex has exactly 4 influences (unused ones have weight 0); vectors are padded to 4 floats
+// so each one is a single load.
+struct SkinningStreams
+{
+	SkinningStreams(PE::GameContext &context, PE::MemoryArena arena);
+
+	// pNormals and pTangents may be NULL
+	void build(PositionBufferCPU *pPositions, NormalBufferCPU *pNormals, TangentBufferCPU *pTangents, SkinWeightsCPU *pWeights);
+
+	// Frees the streams; returns the bytes freed
+	PrimitiveTypes::UInt32 clear();
+
+	// Data --------------------------------------------------------------------
+	int m_numVertices;
+	Array<PrimitiveTypes::Float32> m_positions; // x y z 1
+	Array<PrimitiveTypes::Float32> m_normals;   // x y z 0, empty without normals
+	Array<PrimitiveTypes::Float32> m_tangents;  // x y z 0, empty without tangents
+	Array<PrimitiveTypes::UInt16> m_jointIndices; // 4 per vertex
+	Array<PrimitiveTypes::Float32> m_weights;     // 4 per vertex, sum to 1
+	int m_numDroppedInfluences; // weakest influences of vertices with more than 4, their weight is redistributed
+};
+
+// Skins vertices on the CPU for hit tests and for backends without compute skinning.
+// The skinning palette is DefaultAnimationSM::m_curPalette, i.e. joint transforms already multiplied
+// by the bind inverses (applyInverses), so there is no per-weight matrix product.
+struct CpuSkinning
+{
+	// Writes 3 floats per vertex to every non-NULL output, split over the job pool in vertex ranges
+	static void skin(const SkinningStreams &streams, const Matrix4x4 *pSkinPalette, int numJoints,
+		PrimitiveTypes::Float32 *pOutPositions, PrimitiveTypes::Float32 *pOutNormals, PrimitiveTypes::Float32 *pOutTangents);
+
+	// Vertices [begin, end) on the calling thread
+	static void skinRange(const SkinningStreams &streams, const Matrix4x4 *pSkinPalette, int numJoints, int begin, int end,
+		PrimitiveTypes::Float32 *pOutPositions, PrimitiveTypes::Float32 *pOutNormals, PrimitiveTypes::Float32 *pOutTangents);
+
+	// The Mesh's streams, built from its CPU buffers the first time they are asked for (reloading the
+	// buffers if they were released). NULL for meshes without skin weights or buffers to build from
+	static SkinningStreams *AcquireStreams(PE::GameContext &context, PE::MemoryArena arena, Mesh *pMesh);
+
+	// Largest position difference between skin() output and per-weight reference skinning, i.e. one
+	// Matrix4x4 transform per entry of pWeights. Vertices that lost influences to the 4 influence limit
+	// are not compared
+	static PrimitiveTypes::Float32 maxReferenceError(const SkinningStreams &streams, const Matrix4x4 *pSkinPalette, int numJoints,
+		PositionBufferCPU *pPositions, SkinWeightsCPU *pWeights, const PrimitiveTypes::Float32 *pSkinnedPositions);
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
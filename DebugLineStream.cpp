@@ -0,0 +1,272 @@
+// APIAbstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "DebugLineStream.h"
+
+// the SSE switch is defined by the header above
+#if PE_DEBUG_LINE_STREAM_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace PE {
+namespace Components {
+
+// Static member variables
+DebugLineStream *DebugLineStream::s_pInstance = NULL;
+Handle DebugLineStream::s_hInstance;
+
+void DebugLineStream::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle handle("DEBUG_LINE_STREAM", sizeof(DebugLineStream));
+	s_pInstance = new(handle) DebugLineStream(context, arena);
+	s_hInstance = handle;
+}
+
+DebugLineStream::DebugLineStream(PE::GameContext &context, PE::MemoryArena arena)
+: m_data(context, arena)
+, m_numFloats(0)
+, m_numSpans(0)
+, m_numDroppedPoints(0)
+, m_numDroppedBoxes(0)
+, m_peakNumFloats(0)
+, m_wasOverBudget(false)
+{
+	memset(&m_lastFrameReport, 0, sizeof(m_lastFrameReport));
+	m_data.reset(PE_DEBUG_LINE_STREAM_MAX_POINTS * 6);
+	m_data.m_size = PE_DEBUG_LINE_STREAM_MAX_POINTS * 6;
+}
+
+PrimitiveTypes::Float32 *DebugLineStream::appendPoints(int numPoints, PrimitiveTypes::Float32 timeToLive)
+{
+	const int numFloats = numPoints * 6;
+	if (numFloats <= 0)
+		return NULL;
+
+	if (m_numFloats + numFloats > (int)(m_data.m_size))
+	{
+		m_numDroppedPoints += numPoints;
+		return NULL;
+	}
+
+	// extend the last span if it has the same lifetime, which is the case for almost all lines
+	if (m_numSpans && m_spans[m_numSpans - 1].m_lifetime == timeToLive)
+	{
+		m_spans[m_numSpans - 1].m_numFloats += numFloats;
+	}
+	else
+	{
+		if (m_numSpans == PE_DEBUG_LINE_STREAM_MAX_SPANS)
+		{
+			m_numDroppedPoints += numPoints;
+			return NULL;
+		}
+		Span &span = m_spans[m_numSpans++];
+		span.m_firstFloat = m_numFloats;
+		span.m_numFloats = numFloats;
+		span.m_lifetime = timeToLive;
+	}
+
+	PrimitiveTypes::Float32 *pDst = m_data.getFirstPtr() + m_numFloats;
+	m_numFloats += numFloats;
+	return pDst;
+}
+
+bool DebugLineStream::appendPoints(const PrimitiveTypes::Float32 *pSrc, int numPoints, PrimitiveTypes::Float32 timeToLive)
+{
+	PrimitiveTypes::Float32 *pDst = appendPoints(numPoints, timeToLive);
+	if (!pDst)
+		return false;
+	memcpy(pDst, pSrc, sizeof(PrimitiveTypes::Float32) * 6 * numPoints);
+	return true;
+}
+
+// corner pairs of the 12 box edges: lower ring, upper ring, verticals
+static const int s_boxEdges[PE_DEBUG_BOX_NUM_POINTS] = {
+	0, 1,  1, 3,  3, 2,  2, 0,
+	4, 5,  5, 7,  7, 6,  6, 4,
+	0, 4,  1, 5,  2, 6,  3, 7 };
+
+#if PE_DEBUG_LINE_STREAM_USE_SSE
+// Each point is one 16 byte store of (x, y, z, r) and one 8 byte store of (g, b).
+// Corners have w = 0, so adding (0, 0, 0, r) completes the first half.
+static inline PrimitiveTypes::Float32 *writeBoxEdges(PrimitiveTypes::Float32 *pDst, const __m128 *corners, const Vector3 &color)
+{
+	const __m128 red = _mm_setr_ps(0.0f, 0.0f, 0.0f, color.m_x);
+	const __m128 greenBlue = _mm_setr_ps(color.m_y, color.m_z, 0.0f, 0.0f);
+
+	__m128 records[8];
+	for (int i = 0; i < 8; ++i)
+		records[i] = _mm_add_ps(corners[i], red);
+
+	for (int i = 0; i < PE_DEBUG_BOX_NUM_POINTS; ++i)
+	{
+		_mm_storeu_ps(pDst, records[s_boxEdges[i]]);
+		_mm_storel_pi((__m64 *)(pDst + 4), greenBlue);
+		pDst += 6;
+	}
+	return pDst;
+}
+
+static inline __m128 loadPoint(const Vector3 &p)
+{
+	return _mm_setr_ps(p.m_x, p.m_y, p.m_z, 0.0f);
+}
+#endif
+
+static inline PrimitiveTypes::Float32 *writeBoxEdges(PrimitiveTypes::Float32 *pDst, const Vector3 *pCorners, const Vector3 &color)
+{
+#if PE_DEBUG_LINE_STREAM_USE_SSE
+	__m128 corners[8];
+	for (int i = 0; i < 8; ++i)
+		corners[i] = loadPoint(pCorners[i]);
+	return writeBoxEdges(pDst, corners, color);
+#else
+	for (int i = 0; i < PE_DEBUG_BOX_NUM_POINTS; ++i)
+	{
+		const Vector3 &p = pCorners[s_boxEdges[i]];
+		pDst[0] = p.m_x;     pDst[1] = p.m_y;     pDst[2] = p.m_z;
+		pDst[3] = color.m_x; pDst[4] = color.m_y; pDst[5] = color.m_z;
+		pDst += 6;
+	}
+	return pDst;
+#endif
+}
+
+// reserves room for as many of numBoxes as fit and counts the rest as dropped
+static int reserveBoxes(DebugLineStream *pStream, int numBoxes, PrimitiveTypes::Float32 timeToLive, PrimitiveTypes::Float32 *&pDst)
+{
+	const int numFreePoints = ((int)(pStream->m_data.m_size) - pStream->m_numFloats) / 6;
+	int numFit = numFreePoints / PE_DEBUG_BOX_NUM_POINTS;
+	if (numFit > numBoxes)
+		numFit = numBoxes;
+
+	// boxes past the budget; appendPoints() counts its own points if it fails too
+	pStream->m_numDroppedPoints += (numBoxes - numFit) * PE_DEBUG_BOX_NUM_POINTS;
+
+	pDst = numFit ? pStream->appendPoints(numFit * PE_DEBUG_BOX_NUM_POINTS, timeToLive) : NULL;
+	if (!pDst)
+		numFit = 0;
+
+	pStream->m_numDroppedBoxes += numBoxes - numFit;
+	return numFit;
+}
+
+int DebugLineStream::addBoxes(const Vector3 *pCorners, int numBoxes, const Vector3 &color, PrimitiveTypes::Float32 timeToLive)
+{
+	PrimitiveTypes::Float32 *pDst = NULL;
+	const int numFit = reserveBoxes(this, numBoxes, timeToLive, pDst);
+
+	for (int iBox = 0; iBox < numFit; ++iBox)
+		pDst = writeBoxEdges(pDst, &pCorners[iBox * 8], color);
+
+	return numFit;
+}
+
+int DebugLineStream::addBoxes(const Vector3 *pCenters, const Vector3 *pHalfAxes, int numBoxes, const Vector3 &color, PrimitiveTypes::Float32 timeToLive)
+{
+	PrimitiveTypes::Float32 *pDst = NULL;
+	const int numFit = reserveBoxes(this, numBoxes, timeToLive, pDst);
+
+	for (int iBox = 0; iBox < numFit; ++iBox)
+	{
+#if PE_DEBUG_LINE_STREAM_USE_SSE
+		const __m128 c = loadPoint(pCenters[iBox]);
+		const __m128 u = loadPoint(pHalfAxes[iBox * 3 + 0]);
+		const __m128 v = loadPoint(pHalfAxes[iBox * 3 + 1]);
+		const __m128 n = loadPoint(pHalfAxes[iBox * 3 + 2]);
+
+		// same corner order as CollisionShape::build (x, then z, then y)
+		const __m128 lowMinusU = _mm_sub_ps(_mm_sub_ps(c, u), v);
+		const __m128 lowPlusU = _mm_sub_ps(_mm_add_ps(c, u), v);
+		const __m128 highMinusU = _mm_add_ps(_mm_sub_ps(c, u), v);
+		const __m128 highPlusU = _mm_add_ps(_mm_add_ps(c, u), v);
+
+		__m128 corners[8];
+		corners[0] = _mm_sub_ps(lowMinusU, n);
+		corners[1] = _mm_add_ps(lowMinusU, n);
+		corners[2] = _mm_sub_ps(lowPlusU, n);
+		corners[3] = _mm_add_ps(lowPlusU, n);
+		corners[4] = _mm_sub_ps(highMinusU, n);
+		corners[5] = _mm_add_ps(highMinusU, n);
+		corners[6] = _mm_sub_ps(highPlusU, n);
+		corners[7] = _mm_add_ps(highPlusU, n);
+#else
+		const Vector3 &c = pCenters[iBox];
+		const Vector3 &u = pHalfAxes[iBox * 3 + 0];
+		const Vector3 &v = pHalfAxes[iBox * 3 + 1];
+		const Vector3 &n = pHalfAxes[iBox * 3 + 2];
+
+		// same corner order as CollisionShape::build (x, then z, then y)
+		Vector3 corners[8];
+		corners[0] = c - u - v - n;
+		corners[1] = c - u - v + n;
+		corners[2] = c + u - v - n;
+		corners[3] = c + u - v + n;
+		corners[4] = c - u + v - n;
+		corners[5] = c - u + v + n;
+		corners[6] = c + u + v - n;
+		corners[7] = c + u + v + n;
+#endif
+
+		pDst = writeBoxEdges(pDst, corners, color);
+	}
+
+	return numFit;
+}
+
+void DebugLineStream::endFrame()
+{
+	if (m_numFloats > m_peakNumFloats)
+		m_peakNumFloats = m_numFloats;
+
+	m_lastFrameReport.m_numPointsUsed = m_numFloats / 6;
+	m_lastFrameReport.m_numPointsCapacity = (int)(m_data.m_size) / 6;
+	m_lastFrameReport.m_numPointsPeak = m_peakNumFloats / 6;
+	m_lastFrameReport.m_numPointsDropped = m_numDroppedPoints;
+	m_lastFrameReport.m_numBoxesDropped = m_numDroppedBoxes;
+
+	// per-frame drop counts are in the capacity report; only the first frame over budget is logged
+	if (m_numDroppedPoints && !m_wasOverBudget)
+	{
+		PEINFO("DebugLineStream: budget of %d points exhausted, dropped %d points (%d boxes)\n",
+			m_lastFrameReport.m_numPointsCapacity, m_numDroppedPoints, m_numDroppedBoxes);
+	}
+	m_wasOverBudget = m_numDroppedPoints != 0;
+
+	PrimitiveTypes::Float32 *pData = m_data.getFirstPtr();
+	int numKeptSpans = 0;
+	int numKeptFloats = 0;
+
+	for (int i = 0; i < m_numSpans; ++i)
+	{
+		Span span = m_spans[i];
+		span.m_lifetime -= 1.0f;
+		if (span.m_lifetime < 0.0f)
+			continue;
+
+		// move surviving lines down; spans are in stream order so this never overlaps forward
+		if (span.m_firstFloat != numKeptFloats)
+			memmove(pData + numKeptFloats, pData + span.m_firstFloat, sizeof(PrimitiveTypes::Float32) * span.m_numFloats);
+		span.m_firstFloat = numKeptFloats;
+		numKeptFloats += span.m_numFloats;
+
+		if (numKeptSpans && m_spans[numKeptSpans - 1].m_lifetime == span.m_lifetime)
+			m_spans[numKeptSpans - 1].m_numFloats += span.m_numFloats;
+		else
+			m_spans[numKeptSpans++] = span;
+	}
+
+	m_numSpans = numKeptSpans;
+	m_numFloats = numKeptFloats;
+	m_numDroppedPoints = 0;
+	m_numDroppedBoxes = 0;
+}
+
+}; // namespace Components
+}; // namespace PE
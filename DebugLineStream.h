@@ -0,0 +1,100 @@
+#ifndef __PYENGINE_2_0_DEBUG_LINE_STREAM_H__
+#define __PYENGINE_2_0_DEBUG_LINE_STREAM_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Math/Vector3.h"
+
+// Sibling/Children includes
+#include "PoseBounds.h" // PE_POSE_BOUNDS_USE_SSE
+
+// Budget of debug line points (6 floats each: position, color) kept in the stream
+#define PE_DEBUG_LINE_STREAM_MAX_POINTS (128 * 1024)
+#define PE_DEBUG_LINE_STREAM_MAX_SPANS 256
+#define PE_DEBUG_BOX_NUM_POINTS 24 // 12 edges
+
+#define PE_DEBUG_LINE_STREAM_USE_SSE PE_POSE_BOUNDS_USE_SSE
+
+namespace PE {
+namespace Components {
+
+// Single append-only float stream for all debug lines, allocated once.
+// Points are written in place (or memcpy'd) and uploaded straight from the stream.
+// Runs of points with the same lifetime are kept as spans; endFrame() ages them and compacts
+// the survivors, which is a plain size reset when every line lives for one frame.
+struct DebugLineStream
+{
+	struct Span
+	{
+		int m_firstFloat;
+		int m_numFloats;
+		PrimitiveTypes::Float32 m_lifetime;
+	};
+
+	DebugLineStream(PE::GameContext &context, PE::MemoryArena arena);
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static DebugLineStream *Instance() { return s_pInstance; }
+
+	// Reserves numPoints points that are drawn for timeToLive more frames.
+	// Returns NULL when the budget is used up
+	PrimitiveTypes::Float32 *appendPoints(int numPoints, PrimitiveTypes::Float32 timeToLive);
+
+	// Bulk copy of numPoints points (6 floats each)
+	bool appendPoints(const PrimitiveTypes::Float32 *pSrc, int numPoints, PrimitiveTypes::Float32 timeToLive);
+
+	// Wireframe boxes: all 12 edges of each box in one call. Corners are 8 per box in PhysicsManager order
+	// (lower ring x-z-, x-z+, x+z-, x+z+, then the upper ring). Returns the number of boxes written;
+	// boxes that do not fit are counted in the capacity report
+	int addBoxes(const Vector3 *pCorners, int numBoxes, const Vector3 &color, PrimitiveTypes::Float32 timeToLive);
+
+	// Same, with boxes given as center and three half-axis vectors (3 per box)
+	int addBoxes(const Vector3 *pCenters, const Vector3 *pHalfAxes, int numBoxes, const Vector3 &color, PrimitiveTypes::Float32 timeToLive);
+
+	struct CapacityReport
+	{
+		int m_numPointsUsed;
+		int m_numPointsCapacity;
+		int m_numPointsPeak; // most points held at the end of any frame so far
+		int m_numPointsDropped;
+		int m_numBoxesDropped;
+	};
+
+	// Usage of the last finished frame; DebugRenderer prints it with g_debugLineStreamStats
+	const CapacityReport &getCapacityReport() const { return m_lastFrameReport; }
+
+	// Drops expired spans and ages the rest. Called once per frame
+	void endFrame();
+
+	PrimitiveTypes::Float32 *getData() { return m_data.getFirstPtr(); }
+	int getNumPoints() const { return m_numFloats / 6; }
+
+	// Data --------------------------------------------------------------------
+	Array<PrimitiveTypes::Float32> m_data;
+	int m_numFloats;
+
+	Span m_spans[PE_DEBUG_LINE_STREAM_MAX_SPANS];
+	int m_numSpans;
+
+	int m_numDroppedPoints; // points that did not fit this frame
+	int m_numDroppedBoxes;
+	int m_peakNumFloats;
+	bool m_wasOverBudget; // last frame dropped points; the overflow warning is printed once per run of such frames
+	CapacityReport m_lastFrameReport;
+
+	static DebugLineStream *s_pInstance;
+	static Handle s_hInstance;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
@@ -2,6 +2,7 @@
 #include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
 
 // Outer-Engine includes
+#include <string.h>
 
 // Inter-Engine includes
 #include "../Lua/LuaEnvironment.h"
@@ -15,8 +16,13 @@
 #include "PrimeEngine/Events/StandardEvents.h"
 #include "PrimeEngine/Scene/MeshManager.h"
 #include "PrimeEngine/Scene/MeshInstance.h"
+#include "FrustumCulling.h"
+#include "DebugLineStream.h"
+#include "FrameArena.h"
 
 const bool EnableDebugRendering = true;
+int g_debugCullingStats = 0;
+int g_debugLineStreamStats = 0;
 
 namespace PE {
 namespace Components {
@@ -37,24 +43,23 @@ void DebugRenderer::Construct(PE::GameContext &context, PE::MemoryArena arena)
 	pDebugRenderer->addDefaultComponents();
 	SetInstanceHandle(handle);
 	RootSceneNode::Instance()->addComponent(handle);
+
+	// scene init: frame arenas end their frames from here on, before any system allocates from them
+	if (!FrameArenaSystem::Instance())
+		FrameArenaSystem::Construct(context, arena);
 }
 
 // Constructor -------------------------------------------------------------
 DebugRenderer::DebugRenderer(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself)
 : SceneNode(context, arena, hMyself)
-, m_lineLists(context, arena, NUM_LineLists)
 , m_numFreeing(0)
 {
-	for (int i = 0; i < NUM_LineLists; ++i)
-		m_lineLists.add(Array<float>(context, arena));
-
 	m_numAvaialble = NUM_TextSceneNodes;
 	for (int i = 0; i < NUM_TextSceneNodes; ++i)
 		m_hAvailableSNs[i] = i;
 
-	m_numAvailableLineLists = NUM_LineLists;
-	for (int i = 0; i < NUM_LineLists; ++i)
-		m_availableLineLists[i] = i;
+	// all lines go through one persistent stream
+	DebugLineStream::Construct(context, arena);
 }
 
 // Methods ------------------------------------------------------------
@@ -120,88 +125,72 @@ void DebugRenderer::createRootLineMesh()
 	DebugRenderer::Instance()->createLineMesh(true, m, &linepts[0].m_x, numPts, 0);
 }
 
-void DebugRenderer::createLineMesh(bool hasTransform, const Matrix4x4 &transform, float *pRawData, int numInRawData, float timeToLive, float scale /* = 1.0f*/)
+// Writes the 3 axis lines of a transform (6 points) into pDst
+static void writeAxisLines(float *pDst, const Matrix4x4 &transform, float scale, const Vector3 *pColor)
 {
-	if (EnableDebugRendering && m_numAvailableLineLists)
+	const Vector3 pos = transform.getPos();
+	const Vector3 axisEnds[3] = {
+		pos + transform.getU() * scale,
+		pos + transform.getV() * scale,
+		pos + transform.getN() * scale };
+	static const Vector3 s_axisColors[3] = { Vector3(1.f, 0, 0), Vector3(0, 1.f, 0), Vector3(0, 0, 1.f) };
+
+	for (int iAxis = 0; iAxis < 3; ++iAxis)
 	{
-		const int index = m_availableLineLists[--m_numAvailableLineLists];
-		Array<float> &list = m_lineLists[index];
+		const Vector3 &color = pColor ? *pColor : s_axisColors[iAxis];
+		const Vector3 &end = axisEnds[iAxis];
+		*pDst++ = pos.m_x; *pDst++ = pos.m_y; *pDst++ = pos.m_z;
+		*pDst++ = color.m_x; *pDst++ = color.m_y; *pDst++ = color.m_z;
+		*pDst++ = end.m_x; *pDst++ = end.m_y; *pDst++ = end.m_z;
+		*pDst++ = color.m_x; *pDst++ = color.m_y; *pDst++ = color.m_z;
+	}
+}
 
-		m_lineListLifetimes[index] = timeToLive;
+void DebugRenderer::createLineMesh(bool hasTransform, const Matrix4x4 &transform, float *pRawData, int numInRawData, float timeToLive, float scale /* = 1.0f*/)
+{
+	if (!EnableDebugRendering)
+		return;
 
-		int numPoints = 0;
-		if (hasTransform) numPoints += 3 * 2;
-		if (pRawData)     numPoints += numInRawData;
-		
-		list.reset(numPoints * 6);
+	int numPoints = 0;
+	if (hasTransform) numPoints += 3 * 2;
+	if (pRawData)     numPoints += numInRawData;
 
-		if (hasTransform)
-		{
-			const Vector3 pos = transform.getPos();
-			const Vector3 u   = pos + transform.getU() * scale;
-			const Vector3 v   = pos + transform.getV() * scale;
-			const Vector3 n   = pos + transform.getN() * scale;
-
-			list.add(pos.m_x, pos.m_y, pos.m_z); list.add(1.f, 0, 0); list.add(u.m_x, u.m_y, u.m_z); list.add(1.f, 0, 0); 
-			list.add(pos.m_x, pos.m_y, pos.m_z); list.add(0, 1.f, 0); list.add(v.m_x, v.m_y, v.m_z); list.add(0, 1.f, 0);
-			list.add(pos.m_x, pos.m_y, pos.m_z); list.add(0, 0, 1.f); list.add(n.m_x, n.m_y, n.m_z); list.add(0, 0, 1.f);
-		}
+	float *pDst = DebugLineStream::Instance()->appendPoints(numPoints, timeToLive);
+	if (!pDst)
+		return;
 
-		if (pRawData)
-		{
-			for (int i = 0; i < numInRawData; ++i)
-			{
-				list.add(pRawData[i * 6 + 0]);
-				list.add(pRawData[i * 6 + 1]);
-				list.add(pRawData[i * 6 + 2]);
-				list.add(pRawData[i * 6 + 3]);
-				list.add(pRawData[i * 6 + 4]);
-				list.add(pRawData[i * 6 + 5]);
-			}
-		}
+	if (hasTransform)
+	{
+		writeAxisLines(pDst, transform, scale, NULL);
+		pDst += 3 * 2 * 6;
 	}
+
+	if (pRawData)
+		memcpy(pDst, pRawData, sizeof(float) * 6 * numInRawData);
 }
 
 void DebugRenderer::createAABBLineMesh(bool hasTransform, const Matrix4x4 &transform, float *pRawData, int numInRawData, float timeToLive, float scale /* = 1.0f*/)
 {
-	if (EnableDebugRendering && m_numAvailableLineLists)
-	{
-		const int index = m_availableLineLists[--m_numAvailableLineLists];
-		Array<float> &list = m_lineLists[index];
-
-		m_lineListLifetimes[index] = timeToLive;
-
-		int numPoints = 0;
-		if (hasTransform) numPoints += 3 * 2;
-		if (pRawData)     numPoints += numInRawData;
+	if (!EnableDebugRendering)
+		return;
 
-		list.reset(numPoints * 6);
+	int numPoints = 0;
+	if (hasTransform) numPoints += 3 * 2;
+	if (pRawData)     numPoints += numInRawData;
 
-		if (hasTransform)
-		{
-			const Vector3 pos = transform.getPos();
-			const Vector3 u   = pos + transform.getU() * scale;
-			const Vector3 v   = pos + transform.getV() * scale;
-			const Vector3 n   = pos + transform.getN() * scale;
-
-			list.add(pos.m_x, pos.m_y, pos.m_z); list.add(0, 1.f, 0); list.add(u.m_x, u.m_y, u.m_z); list.add(0, 1.f, 0);
-			list.add(pos.m_x, pos.m_y, pos.m_z); list.add(0, 1.f, 0); list.add(v.m_x, v.m_y, v.m_z); list.add(0, 1.f, 0);
-			list.add(pos.m_x, pos.m_y, pos.m_z); list.add(0, 1.f, 0); list.add(n.m_x, n.m_y, n.m_z); list.add(0, 1.f, 0);
-		}
+	float *pDst = DebugLineStream::Instance()->appendPoints(numPoints, timeToLive);
+	if (!pDst)
+		return;
 
-		if (pRawData)
-		{
-			for (int i = 0; i < numInRawData; ++i)
-			{
-				list.add(pRawData[i * 6 + 0]);
-				list.add(pRawData[i * 6 + 1]);
-				list.add(pRawData[i * 6 + 2]);
-				list.add(pRawData[i * 6 + 3]);
-				list.add(pRawData[i * 6 + 4]);
-				list.add(pRawData[i * 6 + 5]);
-			}
-		}
+	if (hasTransform)
+	{
+		static const Vector3 s_aabbColor(0, 1.f, 0);
+		writeAxisLines(pDst, transform, scale, &s_aabbColor);
+		pDst += 3 * 2 * 6;
 	}
+
+	if (pRawData)
+		memcpy(pDst, pRawData, sizeof(float) * 6 * numInRawData);
 }
 
 void DebugRenderer::createTextMesh(const char *str, bool isOverlay2D, bool is3D, bool is3DFacedToCamera, bool is3DFacedToCameraLockedYAxis, float timeToLive, Vector3 pos, float scale, int &threadOwnershipMask)
@@ -246,6 +235,15 @@ void DebugRenderer::do_PRE_GATHER_DRAWCALLS(Events::Event *pEvt)
 {
 	Events::Event_PRE_GATHER_DRAWCALLS *pDrawEvent = (Events::Event_PRE_GATHER_DRAWCALLS *)(pEvt);
 
+	// once per frame: publish last frame's culling counters
+	MultiViewCuller::FrameViews().endFrame();
+	if (g_debugCullingStats)
+	{
+		const CullingStats &stats = MultiViewCuller::FrameViews().getLastFrameStats();
+		PEINFO("Culling: %u boxes, %u planes evaluated, %u coherency rejects\n",
+			stats.m_numBoxesTested, stats.m_numPlanesEvaluated, stats.m_numCoherencyRejects);
+	}
+
 	while (m_numFreeing)
 		m_hAvailableSNs[m_numAvaialble++] = m_hFreeingSNs[--m_numFreeing];
 
@@ -267,44 +265,24 @@ void DebugRenderer::do_PRE_GATHER_DRAWCALLS(Events::Event *pEvt)
 		}
 	}
 
-	int totalSize = 0;
-	for (int i = 0; i < NUM_LineLists; ++i)
+	// age line spans; one-frame lines are simply reset
+	DebugLineStream *pLineStream = DebugLineStream::Instance();
+	pLineStream->endFrame();
+	if (g_debugLineStreamStats)
 	{
-		Array<float> &list = m_lineLists[i];
-		if (list.m_size)
-		{
-			if (m_lineListLifetimes[i] < 0.0f)
-			{
-				m_availableLineLists[m_numAvailableLineLists++] = i;
-				list.m_size = 0;
-			}
-			m_lineListLifetimes[i] -= 1.0f;
-		}
-		totalSize += list.m_size;
+		const DebugLineStream::CapacityReport &report = pLineStream->getCapacityReport();
+		PEINFO("Debug lines: %d of %d points (peak %d), dropped %d points, %d boxes\n",
+			report.m_numPointsUsed, report.m_numPointsCapacity, report.m_numPointsPeak,
+			report.m_numPointsDropped, report.m_numBoxesDropped);
 	}
 }
 
 void DebugRenderer::postPreDraw(int &threadOwnershipMask)
 {
-	int totalSize = 0;
-	for (int i = 0; i < NUM_LineLists; ++i)
-	{
-		Array<float> &list = m_lineLists[i];
-		if (list.m_size && m_lineListLifetimes[i] >= 0.0f)
-			totalSize += list.m_size;
-	}
-
-	Array<float> vertexData(*m_pContext, m_arena);
-	vertexData.reset(totalSize);
-
-	for (unsigned int i = 0; i < NUM_LineLists; ++i)
-	{
-		Array<float> &list = m_lineLists[i];
-		if (list.m_size && m_lineListLifetimes[i] >= 0.0f)
-			for (unsigned int iv = 0; iv < list.m_size; ++iv)
-				vertexData.add(list[iv]);
-	}
+	DebugLineStream *pStream = DebugLineStream::Instance();
+	const int numPoints = pStream->getNumPoints();
 
+	// the two line meshes are used in turns so the one being drawn is never the one being refilled
 	LineMesh *pLineMesh = m_hLineMeshes[m_currentlyDrawnLineMesh].getObject<LineMesh>();
 	MeshInstance *pLineMeshInstance = m_hLineMeshInstances[m_currentlyDrawnLineMesh].getObject<MeshInstance>();
 	pLineMesh->setEnabled(false);
@@ -314,9 +292,10 @@ void DebugRenderer::postPreDraw(int &threadOwnershipMask)
 	pLineMesh = m_hLineMeshes[m_currentlyDrawnLineMesh].getObject<LineMesh>();
 	pLineMeshInstance = m_hLineMeshInstances[m_currentlyDrawnLineMesh].getObject<MeshInstance>();
 	
-	if (vertexData.m_size)
+	if (numPoints)
 	{
-		pLineMesh->loadFrom3DPoints_needsRC(vertexData.getFirstPtr(), totalSize / 6, "", threadOwnershipMask);
+		// upload straight from the stream, no staging copy
+		pLineMesh->loadFrom3DPoints_needsRC(pStream->getData(), numPoints, "", threadOwnershipMask);
 		pLineMesh->setEnabled(true);
 		pLineMeshInstance->setEnabled(true);
 	}
@@ -325,8 +304,6 @@ void DebugRenderer::postPreDraw(int &threadOwnershipMask)
 		pLineMesh->setEnabled(false);
 		pLineMeshInstance->setEnabled(false);
 	}
-
-	vertexData.reset(0);
 }
 
 }; // namespace Components
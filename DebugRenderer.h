@@ -0,0 +1,83 @@
+#ifndef __PYENGINE_2_0_DEBUG_RENDERER_H__
+#define __PYENGINE_2_0_DEBUG_RENDERER_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "../Events/Component.h"
+
+// Sibling/Children includes
+#include "SceneNode.h"
+
+namespace PE {
+namespace Components {
+
+// Debug text and lines. Text uses a pool of TextSceneNodes; lines of all callers go through DebugLineStream
+// and are drawn by two LineMeshes used in turns.
+struct DebugRenderer : public SceneNode
+{
+	PE_DECLARE_CLASS(DebugRenderer);
+
+	static const int NUM_TextSceneNodes = 512;
+
+	// Singleton ---------------------------------------------------------------
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static DebugRenderer *Instance() { return s_myHandle.getObject<DebugRenderer>(); }
+	static Handle InstanceHandle() { return s_myHandle; }
+	static void SetInstanceHandle(const Handle &handle) { s_myHandle = handle; }
+
+	// Constructor -------------------------------------------------------------
+	DebugRenderer(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself);
+	virtual ~DebugRenderer() {}
+
+	// Component ---------------------------------------------------------------
+	virtual void addDefaultComponents();
+
+	PE_DECLARE_IMPLEMENT_EVENT_HANDLER_WRAPPER(do_PRE_GATHER_DRAWCALLS);
+	virtual void do_PRE_GATHER_DRAWCALLS(Events::Event *pEvt);
+
+	// Methods -----------------------------------------------------------------
+
+	// Grid on the ground plane around the origin
+	static void createRootLineMesh();
+
+	// pRawData holds numInRawData points of 6 floats (position, color), two per line.
+	// With hasTransform the axes of transform are drawn too
+	void createLineMesh(bool hasTransform, const Matrix4x4 &transform, float *pRawData, int numInRawData, float timeToLive, float scale = 1.0f);
+	void createAABBLineMesh(bool hasTransform, const Matrix4x4 &transform, float *pRawData, int numInRawData, float timeToLive, float scale = 1.0f);
+
+	void createTextMesh(const char *str, bool isOverlay2D, bool is3D, bool is3DFacedToCamera, bool is3DFacedToCameraLockedYAxis,
+		float timeToLive, Vector3 pos, float scale, int &threadOwnershipMask);
+
+	// uploads this frame's lines; needs the render context
+	void postPreDraw(int &threadOwnershipMask);
+
+private:
+	static Handle s_myHandle;
+
+	// text
+	Handle m_hSNPool[NUM_TextSceneNodes];
+	float m_lifetimes[NUM_TextSceneNodes];
+	int m_hAvailableSNs[NUM_TextSceneNodes];
+	int m_numAvaialble;
+	int m_hFreeingSNs[NUM_TextSceneNodes];
+	int m_numFreeing;
+
+	// lines
+	Handle m_hLineMeshes[2];
+	Handle m_hLineMeshInstances[2];
+	int m_currentlyDrawnLineMesh;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
@@ -5,6 +5,7 @@
 #include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
 
 // Outer-Engine includes
+#include <string.h>
 
 // Inter-Engine includes
 #include "PrimeEngine/FileSystem/FileReader.h"
@@ -17,6 +18,8 @@
 #include "PrimeEngine/Scene/Skeleton.h"
 #include "PrimeEngine/APIAbstraction/GPUBuffers/VertexBufferGPUManager.h"
 #include "PrimeEngine/Scene/DebugRenderer.h"
+#include "PrimeEngine/Scene/DebugLineStream.h"
+#include "PrimeEngine/Scene/MeshCpuResidency.h"
 #include "../Lua/LuaEnvironment.h"
 #include "PrimeEngine/Geometry/SkeletonCPU/SkeletonCPU.h"
 #include "PrimeEngine/APIAbstraction/GPUBuffers/AnimSetBufferGPU.h"
@@ -25,15 +28,28 @@
 #include "SceneNode.h"
 #include "DrawList.h"
 #include "SH_DRAW.h"
+#include "CameraManager.h"
+#include "CameraSceneNode.h"
 
 #include "DefaultAnimationSM.h"
 
 #include "CharacterControl/PhysicsManager.h"
+#include "PoseBounds.h"
+#include "SkinJointBounds.h"
+#include "SkeletonHitVolumes.h"
+#include "AnimationSystem.h"
+#include "AnimationLod.h"
+#include "PoseCache.h"
+#include "PaletteOps.h"
+#include "BindPoseCache.h"
+#include "CpuSkinning.h"
 
 int g_iDebugBoneSegment = -1;
 int g_debugSkinning = 0;
 int g_disableSkinRender = 0;
 int g_debugSkinNormals = 0;
+int g_debugHitVolumes = 0;
+int g_validateCpuSkinning = 0; // with g_debugSkinning: compare CpuSkinning against per-weight skinning
 namespace PE {
 
 namespace Components {
@@ -261,6 +277,234 @@ void DefaultAnimationSM::do_SCENE_GRAPH_UPDATE(Events::Event *pEvt)
 }
 
 
+// Moves the hit capsules with the scene node. Capsules are shaped (which allocates) in the serial step,
+// see updatePhysicsBounds()
+static void placeHitVolumes(SkeletonInstance *pSkelInst, const Matrix4x4 *pSkinPalette, int numJoints)
+{
+	SceneNode *pSN = pSkelInst->getFirstParentByTypePtr<SceneNode>();
+	if (pSN && pSkelInst->m_hHitVolumes.isValid())
+	{
+		SkeletonHitVolumes *pHitVolumes = pSkelInst->m_hHitVolumes.getObject<SkeletonHitVolumes>();
+		if (pHitVolumes->isBuilt())
+			pHitVolumes->update(pSN->m_worldTransform, pSkinPalette, numJoints);
+	}
+}
+
+// Model space bounds of the current pose, kept on the skeleton instance, and the placed hit capsules.
+// Runs with every palette update, independent of debug drawing, and only touches this skeleton's data.
+// Skinned meshes with joint boxes give the mesh extent; joint positions are the fallback
+static void updatePoseBounds(SkeletonInstance *pSkelInst, const Matrix4x4 *pModelSpacePalette, const Matrix4x4 *pSkinPalette, int numJoints)
+{
+	bool haveSkinBounds = false;
+
+	int index = -1;
+	MeshInstance *pMeshInst = NULL;
+	while (pSkelInst->getFirstComponentIP<MeshInstance>(index+1, index, pMeshInst))
+	{
+		Mesh *pMesh = pMeshInst->getFirstParentByTypePtr<Mesh>();
+		if (!pMesh || !pMesh->m_hSkinJointBounds.isValid())
+			continue;
+
+		Vector3 mn, mx;
+		if (!pMesh->m_hSkinJointBounds.getObject<SkinJointBounds>()->computePoseBounds(pSkinPalette, numJoints, mn, mx))
+			continue;
+
+		if (!haveSkinBounds)
+		{
+			pSkelInst->m_poseBoundsMin = mn;
+			pSkelInst->m_poseBoundsMax = mx;
+			haveSkinBounds = true;
+			continue;
+		}
+
+		Vector3 &bMin = pSkelInst->m_poseBoundsMin;
+		Vector3 &bMax = pSkelInst->m_poseBoundsMax;
+		if (mn.m_x < bMin.m_x) bMin.m_x = mn.m_x;
+		if (mn.m_y < bMin.m_y) bMin.m_y = mn.m_y;
+		if (mn.m_z < bMin.m_z) bMin.m_z = mn.m_z;
+		if (mx.m_x > bMax.m_x) bMax.m_x = mx.m_x;
+		if (mx.m_y > bMax.m_y) bMax.m_y = mx.m_y;
+		if (mx.m_z > bMax.m_z) bMax.m_z = mx.m_z;
+	}
+
+	if (!haveSkinBounds)
+		PoseBounds::computeJointBounds(pModelSpacePalette, numJoints, pSkelInst->m_poseBoundsMin, pSkelInst->m_poseBoundsMax);
+	pSkelInst->m_hasPoseBounds = true;
+
+	placeHitVolumes(pSkelInst, pSkinPalette, numJoints);
+}
+
+// First time setup of the hit capsules from the skinned meshes' joint boxes
+static void buildHitVolumes(SkeletonInstance *pSkelInst, SceneNode *pSN, const Matrix4x4 *pSkinPalette, int numJoints)
+{
+	SkeletonHitVolumes *pHitVolumes = pSkelInst->m_hHitVolumes.getObject<SkeletonHitVolumes>();
+
+	int index = -1;
+	MeshInstance *pMeshInst = NULL;
+	while (pSkelInst->getFirstComponentIP<MeshInstance>(index+1, index, pMeshInst))
+	{
+		Mesh *pMesh = pMeshInst->getFirstParentByTypePtr<Mesh>();
+		if (pMesh && pMesh->m_hSkinJointBounds.isValid())
+			pHitVolumes->addJointBoxes(*pMesh->m_hSkinJointBounds.getObject<SkinJointBounds>());
+	}
+
+	if (pHitVolumes->isBuilt())
+		pHitVolumes->update(pSN->m_worldTransform, pSkinPalette, numJoints);
+}
+
+// World box of the skeleton's PhysicsManager from the pose bounds, and the collision test.
+// Reads other objects' physics state, so it runs serially
+static void updatePhysicsBounds(SkeletonInstance *pSkelInst, const Matrix4x4 *pSkinPalette, int numJoints)
+{
+	SceneNode *pSN = pSkelInst->getFirstParentByTypePtr<SceneNode>();
+	if (!pSN)
+		return;
+
+	if (pSkelInst->m_hHitVolumes.isValid() && !pSkelInst->m_hHitVolumes.getObject<SkeletonHitVolumes>()->isBuilt())
+		buildHitVolumes(pSkelInst, pSN, pSkinPalette, numJoints);
+
+	PhysicsManager *pPhyManager = pSkelInst->getFirstComponent<PhysicsManager>();
+	if (!pPhyManager || !pSkelInst->m_hasPoseBounds)
+		return;
+
+	// skeleton bounds are kept as a world aligned box
+	Vector3 worldMin, worldMax;
+	PoseBounds::transformBounds(pSN->m_worldTransform, pSkelInst->m_poseBoundsMin, pSkelInst->m_poseBoundsMax, worldMin, worldMax);
+
+	pPhyManager->buildBoundingVolume(worldMin.m_x, worldMax.m_x, worldMin.m_y, worldMax.m_y, worldMin.m_z, worldMax.m_z);
+	Matrix4x4 iM;
+	pPhyManager->buildBoundingVolumeAfterTransform(iM);
+	pPhyManager->collisionDetectionAll();
+}
+
+// Builds the model space palette for this frame's animation LOD action and the skinning palette from it.
+// Runs on any job pool thread
+static void evaluatePalette(DefaultAnimationSM *pSM, bool haveAnim)
+{
+	SkeletonInstance *pSkelInstance = pSM->getFirstParentByTypePtr<SkeletonInstance>();
+	Skeleton *pSkeleton = pSkelInstance->getFirstParentByTypePtr<Skeleton>();
+	SkeletonCPU *pSkelCPU = pSkeleton->m_hSkeletonCPU.getObject<SkeletonCPU>();
+	AnimationLodState &lod = pSkelInstance->m_animLod;
+
+	if (!haveAnim)
+	{
+		// idle instances share the Skeleton's bind pose; once copied there is nothing left to compute
+		const BindPose *pBindPose = BindPoseCache::Instance() ? BindPoseCache::Instance()->find(pSkelInstance->m_skeletonAssetHash) : NULL;
+		if (pBindPose && pBindPose->m_numJoints == (int)(pSM->m_curPalette.m_size))
+		{
+			if (!pSkelInstance->m_paletteIsBindPose)
+			{
+				memcpy(pSM->m_modelSpacePalette.getFirstPtr(), pBindPose->m_modelSpacePalette.getFirstPtr(), sizeof(Matrix4x4) * pBindPose->m_numJoints);
+				memcpy(pSM->m_curPalette.getFirstPtr(), pBindPose->m_skinPalette.getFirstPtr(), sizeof(Matrix4x4) * pBindPose->m_numJoints);
+				updatePoseBounds(pSkelInstance, pSM->m_modelSpacePalette.getFirstPtr(), pSM->m_curPalette.getFirstPtr(), pSM->m_curPalette.m_size);
+				pSkelInstance->m_paletteIsBindPose = true;
+			}
+			else
+			{
+				placeHitVolumes(pSkelInstance, pSM->m_curPalette.getFirstPtr(), pSM->m_curPalette.m_size);
+			}
+			return;
+		}
+
+		// not cached (the cache was full): the palettes still hold the bind pose this instance computed last time
+		if (pSkelInstance->m_paletteIsBindPose)
+		{
+			placeHitVolumes(pSkelInstance, pSM->m_curPalette.getFirstPtr(), pSM->m_curPalette.m_size);
+			return;
+		}
+	}
+	pSkelInstance->m_paletteIsBindPose = false;
+
+	if (lod.m_action == AnimationLodState::INTERPOLATE)
+	{
+		AnimationLod::interpolatePose(lod, pSM->m_modelSpacePalette.getFirstPtr(), pSM->m_modelSpacePalette.m_size);
+	}
+	else if (haveAnim)
+	{
+		// crowds playing the same clips at the same frame share one evaluation
+		PoseCache *pCache = pSkelInstance->m_poseCacheable ? PoseCache::Instance() : NULL;
+		if (!pCache || !pCache->lookup(pSkelInstance->m_poseCacheKey, pSM->m_modelSpacePalette.getFirstPtr(), pSM->m_modelSpacePalette.m_size))
+		{
+			pSkelCPU->prepareMatrixPalette(pSkelInstance->m_hAnimationSetGPUs, pSM->m_animSlots,
+				pSM->m_additionalLocalTransforms, pSM->m_additionalLocalTransformFlags,
+				pSM->m_modelSpacePalette);
+
+			// uniform skin scale only touches the 3x4 affine part, 4 floats at a time; checked against the Matrix4x4
+			// scale multiply over the whole palette when g_validateFastPalette is set
+			PaletteOps::applyUniformScale(pSM->m_modelSpacePalette.getFirstPtr(), (int)(pSM->m_modelSpacePalette.m_size), pSkeleton->m_skinScaleFactor);
+
+			if (pCache)
+				pCache->insert(pSkelInstance->m_poseCacheKey, pSM->m_modelSpacePalette.getFirstPtr(), pSM->m_modelSpacePalette.m_size);
+			else if (PoseCache::Instance())
+				PoseCache::Instance()->noteUncacheable();
+		}
+	}
+	else
+	{
+		// load bind pose
+		pSkelCPU->prepareBindPoseMatrixPalette(pSM->m_modelSpacePalette, true);
+	}
+
+	// reduced rate skeletons show their evaluated poses blended over the interval
+	if (lod.m_action == AnimationLodState::EVALUATE && lod.m_interval > 1)
+		AnimationLod::storeEvaluatedPose(lod, pSM->m_modelSpacePalette.getFirstPtr(), pSM->m_modelSpacePalette.m_size);
+
+	// finally add inverse transformation of vertices into local space of the bones (bind pose transformation)
+	// need to apply it, because vertices are stored as if they were a simple mesh (that is in bind pose)
+	// so we need to get them into bone space (by multiplying by bind pose joint inverse)
+	// and then move with joint (by multiplying by joint transformation)
+	PEASSERT(pSM->m_modelSpacePalette.m_size == pSM->m_curPalette.m_size, "Palettes must be same size");
+	pSkelCPU->applyInverses(pSM->m_curPalette.getFirstPtr(), pSM->m_modelSpacePalette.getFirstPtr());
+
+	updatePoseBounds(pSkelInstance, pSM->m_modelSpacePalette.getFirstPtr(), pSM->m_curPalette.getFirstPtr(), pSM->m_curPalette.m_size);
+
+	// an idle pose evaluated here is the bind pose; kept until a slot becomes active
+	if (!haveAnim && lod.m_action != AnimationLodState::INTERPOLATE)
+		pSkelInstance->m_paletteIsBindPose = true;
+}
+
+// AnimationSystem jobs
+static void evaluateAnimatedPaletteJob(Component *pComponent)
+{
+	evaluatePalette((DefaultAnimationSM *)(pComponent), true);
+}
+
+static void evaluateBindPosePaletteJob(Component *pComponent)
+{
+	evaluatePalette((DefaultAnimationSM *)(pComponent), false);
+}
+
+// Pose not needed: the skeleton is culled by every view, so it keeps last frame's palette and pose bounds.
+// Only the hit capsules follow the scene node; the post step moves the physics box
+static void updateCulledBoundsJob(Component *pComponent)
+{
+	DefaultAnimationSM *pSM = (DefaultAnimationSM *)(pComponent);
+	placeHitVolumes(pSM->getFirstParentByTypePtr<SkeletonInstance>(), pSM->m_curPalette.getFirstPtr(), pSM->m_curPalette.m_size);
+}
+
+// Computes the Skeleton's bind pose into this instance's palettes the first time it is needed. Serial
+static void cacheBindPose(DefaultAnimationSM *pSM, SkeletonInstance *pSkelInst, SkeletonCPU *pSkelCPU)
+{
+	// skeletons that did not fit evaluate their bind pose once per instance instead
+	BindPoseCache *pCache = BindPoseCache::Instance();
+	if (pSkelInst->m_skeletonAssetHash == 0 || pCache->isFull() || pCache->find(pSkelInst->m_skeletonAssetHash))
+		return;
+
+	pSkelCPU->prepareBindPoseMatrixPalette(pSM->m_modelSpacePalette, true);
+	pSkelCPU->applyInverses(pSM->m_curPalette.getFirstPtr(), pSM->m_modelSpacePalette.getFirstPtr());
+	pCache->add(pSkelInst->m_skeletonAssetHash, pSM->m_modelSpacePalette.getFirstPtr(), pSM->m_curPalette.getFirstPtr(), pSM->m_curPalette.m_size);
+
+	// the job still copies it to compute this instance's bounds
+	pSkelInst->m_paletteIsBindPose = false;
+}
+
+// AnimationSystem post step, serial
+static void finishPaletteJob(Component *pComponent)
+{
+	DefaultAnimationSM *pSM = (DefaultAnimationSM *)(pComponent);
+	updatePhysicsBounds(pSM->getFirstParentByTypePtr<SkeletonInstance>(), pSM->m_curPalette.getFirstPtr(), pSM->m_curPalette.m_size);
+}
+
 void DefaultAnimationSM::do_CALCULATE_TRANSFORMATIONS(Events::Event *pEvt)
 {
 	Handle hParentSkinInstance = getFirstParentByType<SkeletonInstance>();
@@ -289,43 +533,73 @@ void DefaultAnimationSM::do_CALCULATE_TRANSFORMATIONS(Events::Event *pEvt)
 				break;
 			}
 		}
-		
-		if (haveAnim)
+
+		// cache key of the blended pose; poses with additional local transforms are per instance
+		pSkelInstance->m_poseCacheable = false;
+		if (haveAnim && PoseCache::Enabled())
 		{
-			pSkelCPU->prepareMatrixPalette(pSkelInstance->m_hAnimationSetGPUs, m_animSlots,
-				m_additionalLocalTransforms, m_additionalLocalTransformFlags,
-				m_modelSpacePalette);
+			if (!PoseCache::Instance())
+				PoseCache::Construct(*m_pContext, m_arena);
 
-			Matrix4x4 scale;
-			scale.importScale(pSkeleton->m_skinScaleFactor, pSkeleton->m_skinScaleFactor, pSkeleton->m_skinScaleFactor);
+			PoseCacheKey &key = pSkelInstance->m_poseCacheKey;
+			key.clear();
+			key.m_pSkeleton = pSkeleton;
 
-			for (PrimitiveTypes::UInt32 ijoint = 0; ijoint < m_modelSpacePalette.m_size; ijoint++)
+			bool cacheable = m_curPalette.m_size <= PE_POSE_CACHE_MAX_JOINTS;
+			for (PrimitiveTypes::UInt32 iSlot = 0; cacheable && iSlot < m_animSlots.m_size; iSlot++)
 			{
-				m_modelSpacePalette[ijoint] = scale * m_modelSpacePalette[ijoint];
+				AnimationSlot &slot = m_animSlots[iSlot];
+				if (slot.m_flags & ACTIVE)
+				{
+					cacheable = key.addSlot(pSkelInstance->m_hAnimationSetGPUs[slot.m_animationSetIndex].getObject<AnimSetBufferGPU>(),
+						slot.m_animationIndex, slot.m_frameIndex, slot.m_weight, slot.m_flags);
+				}
+			}
+			for (PrimitiveTypes::UInt32 ij = 0; cacheable && ij < m_additionalLocalTransformFlags.m_size; ij++)
+			{
+				if (m_additionalLocalTransformFlags[ij])
+					cacheable = false;
 			}
+
+			key.finalize();
+			pSkelInstance->m_poseCacheable = cacheable;
 		}
-		else
+
+		// update rate from distance and visibility reported by last frame's culling
+		AnimationSystem::EvaluateFunction evaluate = NULL;
+		switch (AnimationLod::beginUpdate(pSkelInstance->m_animLod, AnimationSystem::Instance()->getFrameIndex(), m_curPalette.m_size))
 		{
-			// load bind pose
-			pSkelCPU->prepareBindPoseMatrixPalette(m_modelSpacePalette, true);
+		case AnimationLodState::EVALUATE:
+			evaluate = haveAnim ? &evaluateAnimatedPaletteJob : &evaluateBindPosePaletteJob;
+			break;
+		case AnimationLodState::INTERPOLATE:
+			evaluate = &evaluateAnimatedPaletteJob;
+			break;
+		case AnimationLodState::BIND_POSE:
+			evaluate = &evaluateBindPosePaletteJob;
+			break;
+		case AnimationLodState::FREEZE:
+			evaluate = &updateCulledBoundsJob;
+			break;
 		}
 
-		Matrix4x4 tmp;
-		tmp.loadIdentity();
+		// an idle pose does not change, so it is neither interpolated nor blended from later on
+		if (!haveAnim && evaluate != &updateCulledBoundsJob)
+		{
+			evaluate = &evaluateBindPosePaletteJob;
+			pSkelInstance->m_animLod.m_hasTargetPose = false;
+		}
 
-		Handle hp = getFirstParentByType<SceneNode>();
-		if (hp.isValid())
-		{	
-			tmp = hp.getObject<PE::Components::SceneNode>()->m_base;
+		if (evaluate == &evaluateBindPosePaletteJob)
+		{
+			if (!BindPoseCache::Instance())
+				BindPoseCache::Construct(*m_pContext, m_arena);
+			cacheBindPose(this, pSkelInstance, pSkelCPU);
 		}
 
-		// finally add inverse transformation of vertices into local space of the bones (bind pose transformation)
-		// need to apply it, because vertices are stored as if they were a simple mesh (that is in bind pose)
-		// so we need to get them into bone space (by multiplying by bind pose joint inverse)
-		// and then move with joint (by multiplying by joint transformation)
-		PEASSERT(m_modelSpacePalette.m_size == m_curPalette.m_size, "Palettes must be same size");
-		pSkelCPU->applyInverses(m_curPalette.getFirstPtr(), m_modelSpacePalette.getFirstPtr());
-	}	
+		// palettes of all skeletons are evaluated together on the job pool, see AnimationSystem::flush()
+		AnimationSystem::Instance()->enqueue(this, evaluate, &finishPaletteJob);
+	}
 }
 
 // this event is executed when thread has RC
@@ -334,9 +608,8 @@ void DefaultAnimationSM::do_PRE_RENDER_needsRC(PE::Events::Event *pEvt)
 	Event_PRE_RENDER_needsRC *pRealEvt = (Event_PRE_RENDER_needsRC *)(pEvt);
     SceneNode *pSN = getFirstParentByTypePtr<SkeletonInstance>()->getFirstParentByTypePtr<SceneNode>();
     
-	static bool debugSkeleton = true;
-	if (!debugSkeleton)
-		return;
+	// palettes queued during Event_CALCULATE_TRANSFORMATIONS are needed from here on
+	AnimationSystem::Instance()->flush();
 
 	SkeletonInstance *pSkelInst = getFirstParentByTypePtr<SkeletonInstance>();
 	Skeleton *pSkel = pSkelInst->getFirstParentByTypePtr<Skeleton>();
@@ -350,17 +623,29 @@ void DefaultAnimationSM::do_PRE_RENDER_needsRC(PE::Events::Event *pEvt)
 
 		// the result already has bind inverse multiplied in, so we need to undo it
 
-		pSkelCPU->prepareBindPoseMatrixPalette(m_modelSpacePalette, true);
+		const BindPose *pBindPose = BindPoseCache::Instance() ? BindPoseCache::Instance()->find(pSkelInst->m_skeletonAssetHash) : NULL;
+		if (pBindPose && pBindPose->m_numJoints == (int)(m_modelSpacePalette.m_size))
+			memcpy(m_modelSpacePalette.getFirstPtr(), pBindPose->m_modelSpacePalette.getFirstPtr(), sizeof(Matrix4x4) * pBindPose->m_numJoints);
+		else
+			pSkelCPU->prepareBindPoseMatrixPalette(m_modelSpacePalette, true);
+		pSkelInst->m_paletteIsBindPose = false;
 
 		for (int i = 0; i < m_modelSpacePalette.m_size; ++i)
 		{
 			m_modelSpacePalette[i] = pPalette[i] * m_modelSpacePalette[i];
 		}
+
+		// compute shader palettes are only known here
+		updatePoseBounds(pSkelInst, m_modelSpacePalette.getFirstPtr(), pPalette, m_modelSpacePalette.m_size);
+		updatePhysicsBounds(pSkelInst, pPalette, m_modelSpacePalette.m_size);
 	}
 #endif
-	// render skeleton
-	float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX, maxZ = -FLT_MAX;
 
+	static bool debugSkeleton = true;
+	if (!debugSkeleton)
+		return;
+
+	// render skeleton
 	float scale = 100.0f;
 	if (g_iDebugBoneSegment < 0 && !g_debugSkinning)
 	{
@@ -373,30 +658,47 @@ void DefaultAnimationSM::do_PRE_RENDER_needsRC(PE::Events::Event *pEvt)
 			m.setN(m.getN() * scale);
 
 			DebugRenderer::Instance()->createLineMesh(true, m, NULL, 0, 0, 0.2f);
-
-			float x = m.getPos().getX();
-			float y = m.getPos().getY();
-			float z = m.getPos().getZ();
-
-			PhysicsManager::setExtremeValue(x, y, z, minX, maxX, minY, maxY, minZ, maxZ);
 		}
 
+		// bounds were built with the palette, this only draws them
 		PhysicsManager *pPhyManager = pSkelInst->getFirstComponent<PhysicsManager>();
-		if (pPhyManager)
+		if (pPhyManager && pSkelInst->m_hasPoseBounds)
 		{
-			// build bounding box
-			pPhyManager->buildBoundingVolume(minX, maxX, minY, maxY, minZ, maxZ);
-			Matrix4x4 iM;
-			pPhyManager->buildBoundingVolumeAfterTransform(iM);
-			pPhyManager->collisionDetectionAll();
-
-			// draw AABB
-			for (int i = 0; i < 4; ++i)
-			{
-				// draw AABB boxes by 4 matrices from 4 vertices
-				DebugRenderer::Instance()->createAABBLineMesh(true,
-					pPhyManager->m_boundingBoxAfterTransform[i], NULL, 0, 0);
-			}
+			// draw AABB, all 12 edges at once
+			DebugLineStream::Instance()->addBoxes(&pPhyManager->m_boundingBoxVertexAfterTransform[0], 1, Vector3(0.0f, 1.0f, 0.0f), 0);
+		}
+	}
+
+	// hit volumes: marks the bone under the camera's view ray and the bone the camera is inside of
+	if (g_debugHitVolumes && pSkelInst->m_hHitVolumes.isValid())
+	{
+		const SkeletonHitVolumes *pHitVolumes = pSkelInst->m_hHitVolumes.getObject<SkeletonHitVolumes>();
+		CameraSceneNode *pCam = CameraManager::Instance()->getActiveCamera()->getCamSceneNode();
+		const Vector3 camPos = pCam->m_worldTransform.getPos();
+
+		static float s_hitRayLength = 100.0f;
+		PrimitiveTypes::Float32 t = 0.0f;
+		const int rayJoint = pHitVolumes->isBuilt() ? pHitVolumes->raycast(camPos, camPos + pCam->m_worldTransform.getN() * s_hitRayLength, &t) : -1;
+		const int touchJoint = pHitVolumes->isBuilt() ? pHitVolumes->overlapSphere(camPos, 0.5f) : -1;
+
+		const int markedJoints[2] = { rayJoint, touchJoint };
+		for (int i = 0; i < 2; ++i)
+		{
+			if (markedJoints[i] < 0 || markedJoints[i] >= (int)(m_modelSpacePalette.m_size))
+				continue;
+
+			Matrix4x4 m = pSN->m_worldTransform * m_modelSpacePalette[markedJoints[i]];
+			m.setU(m.getU() * scale * 2.0f);
+			m.setV(m.getV() * scale * 2.0f);
+			m.setN(m.getN() * scale * 2.0f);
+			DebugRenderer::Instance()->createLineMesh(true, m, NULL, 0, 0, 0.2f);
+
+			char buf[64];
+			if (i == 0)
+				sprintf(buf, "hit %d t=%.2f", markedJoints[i], t * s_hitRayLength);
+			else
+				sprintf(buf, "touch %d", markedJoints[i]);
+			DebugRenderer::Instance()->createTextMesh(buf, false, true, true, false, 0.0f, m.getPos(), 0.5f, pRealEvt->m_threadOwnershipMask);
 		}
 	}
 
@@ -408,10 +710,9 @@ void DefaultAnimationSM::do_PRE_RENDER_needsRC(PE::Events::Event *pEvt)
 	while (pSkelInst->getFirstComponentIP<MeshInstance>(index+1, index, pMeshInst))
 	{
 		Mesh *pMesh = pMeshInst->getFirstParentByTypePtr<Mesh>();
+		if (!pMesh)
+			continue; // still loading
 		SkinWeightsCPU *pWeights = pMesh->m_hSkinWeightsCPU.getObject<SkinWeightsCPU>();
-		PositionBufferCPU *pPoss = pMesh->m_hPositionBufferCPU.getObject<PositionBufferCPU>();
-		NormalBufferCPU *pNorms = pMesh->m_hNormalBufferCPU.getObject<NormalBufferCPU>();
-		TangentBufferCPU *pTangs = pMesh->m_hTangentBufferCPU.getObject<TangentBufferCPU>();
 		IndexBufferGPU *pIB = pMesh->m_hIndexBufferGPU.getObject<IndexBufferGPU>();
 		
 		for (int iIndexRange = 0; iIndexRange < pIB->m_indexRanges.m_size; ++iIndexRange)
@@ -438,8 +739,14 @@ void DefaultAnimationSM::do_PRE_RENDER_needsRC(PE::Events::Event *pEvt)
 
 		// debug skinning
 
-		if (g_debugSkinning)
+		// the CPU vertex buffers are released after load and the skinning streams are built on first use;
+		// both happen here the first time the mesh is debugged
+		SkinningStreams *pStreams = g_debugSkinning && MeshCpuResidency::Acquire(pMesh) ? CpuSkinning::AcquireStreams(*m_pContext, m_arena, pMesh) : NULL;
+		if (pStreams)
 		{
+			PositionBufferCPU *pPoss = pMesh->m_hPositionBufferCPU.getObject<PositionBufferCPU>();
+			NormalBufferCPU *pNorms = pMesh->m_hNormalBufferCPU.getObject<NormalBufferCPU>();
+
 			static float fVertexIndex = 0;
 			static float fInc = 0.5f;
 			fVertexIndex += fInc;
@@ -452,16 +759,30 @@ void DefaultAnimationSM::do_PRE_RENDER_needsRC(PE::Events::Event *pEvt)
 			Array<float> arr(*m_pContext, m_arena);
 			arr.reset(pNorms->m_values.m_size/3 * 2 * 6 * 2);
 
-			for (int i = 0; i < pPoss->m_values.m_size / 3; ++i)
+			// whole mesh skinned at once from the flattened streams, on the job pool
+			const int numVertices = pStreams->m_numVertices;
+			Array<float> skinned(*m_pContext, m_arena);
+			skinned.reset(numVertices * 9);
+			skinned.m_size = numVertices * 9;
+			float *pSkinnedPos = skinned.getFirstPtr();
+			float *pSkinnedNorm = pSkinnedPos + numVertices * 3;
+			float *pSkinnedTang = pSkinnedNorm + numVertices * 3;
+			CpuSkinning::skin(*pStreams, m_curPalette.getFirstPtr(), m_curPalette.m_size, pSkinnedPos, pSkinnedNorm, pSkinnedTang);
+
+			if (g_validateCpuSkinning)
 			{
-				Vector3 pos(pPoss->m_values[i * 3], pPoss->m_values[i * 3 + 1], pPoss->m_values[i * 3 + 2]);
-				Vector3 normal(pNorms->m_values[i * 3], pNorms->m_values[i * 3 + 1], pNorms->m_values[i * 3 + 2]);
-				Vector3 tangent(pTangs->m_values[i * 3], pTangs->m_values[i * 3 + 1], pTangs->m_values[i * 3 + 2]);
-
+				const float maxError = CpuSkinning::maxReferenceError(*pStreams, m_curPalette.getFirstPtr(), m_curPalette.m_size,
+					pPoss, pWeights, pSkinnedPos);
+				PEINFO("CpuSkinning: %s max position error %f against per-weight skinning\n", pMesh->m_meshFileName, maxError);
+				PEASSERT(maxError < 0.001f, "CPU skinning does not match per-weight skinning");
+			}
 
+			for (int i = 0; i < numVertices; ++i)
+			{
 				if (i == vertexIndex)
 				{
 					// this is the vertex we want to debug
+					Vector3 pos(pPoss->m_values[i * 3], pPoss->m_values[i * 3 + 1], pPoss->m_values[i * 3 + 2]);
 					Vector3 posW = pSN->m_worldTransform * pos;
 
 					char buf[256];
@@ -471,45 +792,28 @@ void DefaultAnimationSM::do_PRE_RENDER_needsRC(PE::Events::Event *pEvt)
 					Matrix4x4 m(posW);
 
 					DebugRenderer::Instance()->createLineMesh(true, m, NULL, 0, 0, 0.1f);
-				}
 
-				Vector3 res(0,0,0);
-				Vector3 normRes(0,0,0);
-				Vector3 tangRes(0,0,0);
-
-				Array<WeightPair> &weights = pWeights->m_weightsPerVertex[i];
-				for (int iw = 0; iw < weights.m_size; ++iw)
-				{
-					WeightPair &w = weights[iw];
-
-					Matrix4x4 m = m_modelSpacePalette[w.m_jointIndex];
-
-					Matrix4x4 inv = pSkelCPU->getBindInversesPtr()[w.m_jointIndex];
-					Matrix4x4 mInv = m * inv;
-					Vector3 invTimesPos = inv * pos;
-
-					res = res + (mInv * pos) * w.m_weight;
-					normRes = normRes + (mInv * normal) * w.m_weight;
-					tangRes = tangRes + (mInv * tangent) * w.m_weight;
-
-					if (i == vertexIndex)
+					Array<WeightPair> &weights = pWeights->m_weightsPerVertex[i];
+					for (int iw = 0; iw < weights.m_size; ++iw)
 					{
 						// this joint is used by debugged vertex
-						m = pSN->m_worldTransform * m;
+						WeightPair &w = weights[iw];
+						m = pSN->m_worldTransform * m_modelSpacePalette[w.m_jointIndex];
 						m.setU(m.getU() * 100.0f);
 						m.setV(m.getV() * 100.0f);
 						m.setN(m.getN() * 100.0f);
 
 						DebugRenderer::Instance()->createLineMesh(true, m, NULL, 0, 0, 0.1f);
 
-						char buf[256];
 						sprintf(buf, "%d:%d-%.2f", iw, w.m_jointIndex, w.m_weight);
 						DebugRenderer::Instance()->createTextMesh(buf, false, true, true, false, 0.0f, m.getPos(), 0.5f, pRealEvt->m_threadOwnershipMask);
 					}
-
-
 				}
 
+				Vector3 res(pSkinnedPos[i * 3], pSkinnedPos[i * 3 + 1], pSkinnedPos[i * 3 + 2]);
+				Vector3 normRes(pSkinnedNorm[i * 3], pSkinnedNorm[i * 3 + 1], pSkinnedNorm[i * 3 + 2]);
+				Vector3 tangRes(pSkinnedTang[i * 3], pSkinnedTang[i * 3 + 1], pSkinnedTang[i * 3 + 2]);
+
 				if (g_debugSkinNormals && (!normalsForDebugVertexOnly || i == vertexIndex))
 				{
 					arr.add(res.m_x, res.m_y, res.m_z);
@@ -541,6 +845,7 @@ void DefaultAnimationSM::do_PRE_RENDER_needsRC(PE::Events::Event *pEvt)
 			}
 			DebugRenderer::Instance()->createLineMesh(false, Matrix4x4(), arr.getFirstPtr(), arr.m_size/6, 0, 1.0f);
 			arr.reset(0); // clear memory
+			skinned.reset(0);
 		}
 	}
 }
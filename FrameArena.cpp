@@ -0,0 +1,290 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdlib.h>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+#include <stdint.h>
+#include <atomic>
+#include <new>
+
+// Inter-Engine includes
+#include "PrimeEngine/Events/StandardEvents.h"
+#include "PrimeEngine/Scene/RootSceneNode.h"
+
+// Sibling/Children includes
+#include "FrameArena.h"
+
+int g_debugFrameArenaStats = 0;
+
+#if PE_FRAME_ARENA_COUNT_NEW
+static std::atomic<PE::PrimitiveTypes::UInt32> s_numOperatorNew(0);
+
+static void *countedAllocate(size_t size)
+{
+	s_numOperatorNew.fetch_add(1, std::memory_order_relaxed);
+	return malloc(size ? size : 1);
+}
+
+static void *countedAllocateOrThrow(size_t size)
+{
+	void *p = countedAllocate(size);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+// the whole set is replaced so no form bypasses the count or frees another form's memory
+void *operator new(size_t size) { return countedAllocateOrThrow(size); }
+void *operator new[](size_t size) { return countedAllocateOrThrow(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return countedAllocate(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return countedAllocate(size); }
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+#if defined(__cpp_aligned_new)
+static void *countedAllocateAligned(size_t size, std::align_val_t alignment)
+{
+	s_numOperatorNew.fetch_add(1, std::memory_order_relaxed);
+	size_t align = (size_t)(alignment);
+#if defined(_WIN32)
+	return _aligned_malloc(size ? size : 1, align);
+#else
+	if (align < sizeof(void *))
+		align = sizeof(void *);
+	void *p = NULL;
+	return posix_memalign(&p, align, size ? size : 1) == 0 ? p : NULL;
+#endif
+}
+
+static void *countedAllocateAlignedOrThrow(size_t size, std::align_val_t alignment)
+{
+	void *p = countedAllocateAligned(size, alignment);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+static void freeAligned(void *p)
+{
+#if defined(_WIN32)
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+void *operator new(size_t size, std::align_val_t alignment) { return countedAllocateAlignedOrThrow(size, alignment); }
+void *operator new[](size_t size, std::align_val_t alignment) { return countedAllocateAlignedOrThrow(size, alignment); }
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return countedAllocateAligned(size, alignment); }
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return countedAllocateAligned(size, alignment); }
+
+void operator delete(void *p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { freeAligned(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { freeAligned(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+#endif
+#endif
+
+namespace PE {
+
+static FrameArena *s_arenas[PE_FRAME_ARENA_MAX_THREADS];
+static std::atomic<int> s_numArenas(0);
+static thread_local FrameArena *s_pThreadArena = NULL;
+static PrimitiveTypes::UInt32 s_numHeapAllocationsAtLastEndFrame = 0;
+static PrimitiveTypes::UInt32 s_numHeapAllocationsLastFrame = 0;
+static PrimitiveTypes::UInt32 s_numOperatorNewAtLastEndFrame = 0;
+static PrimitiveTypes::UInt32 s_numOperatorNewLastFrame = 0;
+static PrimitiveTypes::UInt32 s_frameIndex = 0;
+
+FrameArena *FrameArena::Current()
+{
+	if (!s_pThreadArena)
+	{
+		// workers can get here together; EndFrame() only reads the table while no jobs run
+		const int index = s_numArenas.fetch_add(1);
+		PEASSERT(index < PE_FRAME_ARENA_MAX_THREADS, "Too many threads using frame arenas");
+
+		// thread's first frame allocation, not a steady state one
+		s_pThreadArena = new FrameArena();
+		s_arenas[index] = s_pThreadArena;
+	}
+	return s_pThreadArena;
+}
+
+void FrameArena::EndFrame()
+{
+	const int numArenas = s_numArenas.load();
+	for (int i = 0; i < numArenas; ++i)
+		s_arenas[i]->reset();
+	++s_frameIndex;
+
+	const PrimitiveTypes::UInt32 numHeapAllocations = NumHeapAllocations();
+	s_numHeapAllocationsLastFrame = numHeapAllocations - s_numHeapAllocationsAtLastEndFrame;
+	s_numHeapAllocationsAtLastEndFrame = numHeapAllocations;
+
+#if PE_FRAME_ARENA_COUNT_NEW
+	const PrimitiveTypes::UInt32 numOperatorNew = s_numOperatorNew.load(std::memory_order_relaxed);
+	s_numOperatorNewLastFrame = numOperatorNew - s_numOperatorNewAtLastEndFrame;
+	s_numOperatorNewAtLastEndFrame = numOperatorNew;
+#endif
+}
+
+PrimitiveTypes::UInt32 FrameArena::FrameIndex()
+{
+	return s_frameIndex;
+}
+
+PrimitiveTypes::UInt32 FrameArena::NumHeapAllocations()
+{
+	PrimitiveTypes::UInt32 total = 0;
+	const int numArenas = s_numArenas.load();
+	for (int i = 0; i < numArenas; ++i)
+		total += s_arenas[i]->m_numHeapAllocations;
+	return total;
+}
+
+PrimitiveTypes::UInt32 FrameArena::NumHeapAllocationsLastFrame()
+{
+	return s_numHeapAllocationsLastFrame;
+}
+
+PrimitiveTypes::UInt32 FrameArena::NumOperatorNewLastFrame()
+{
+	return s_numOperatorNewLastFrame;
+}
+
+FrameArena::FrameArena()
+: m_pBlock((char *)(malloc(PE_FRAME_ARENA_BLOCK_SIZE)))
+, m_capacity(PE_FRAME_ARENA_BLOCK_SIZE)
+, m_used(0)
+, m_highWater(0)
+, m_pOverflow(NULL)
+, m_overflowBytes(0)
+, m_numHeapAllocations(1)
+{
+}
+
+void *FrameArena::allocate(PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 alignment)
+{
+	// m_pBlock comes from malloc, so aligning the offset aligns the address up to malloc's alignment
+	const PrimitiveTypes::UInt32 offset = (m_used + alignment - 1) & ~(alignment - 1);
+	if (alignment > 16 || offset + size > m_capacity)
+		return allocateOverflow(size, alignment);
+
+	m_used = offset + size;
+	return m_pBlock + offset;
+}
+
+void *FrameArena::allocateOverflow(PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 alignment)
+{
+	// spills bump through blocks as big as the main one, so a frame spills in a few allocations
+	const PrimitiveTypes::UInt32 headerSize = (sizeof(OverflowBlock) + 15) & ~15;
+	OverflowBlock *pBlock = m_pOverflow;
+	uintptr_t start = 0;
+	if (pBlock)
+	{
+		start = ((uintptr_t)((char *)(pBlock) + headerSize + pBlock->m_used) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		if (start + size > (uintptr_t)((char *)(pBlock) + headerSize + pBlock->m_capacity))
+			pBlock = NULL;
+	}
+
+	if (!pBlock)
+	{
+		const PrimitiveTypes::UInt32 capacity = size + alignment > m_capacity ? size + alignment : m_capacity;
+		pBlock = (OverflowBlock *)(malloc(headerSize + capacity));
+		PEASSERT(pBlock, "Frame arena overflow allocation failed");
+		++m_numHeapAllocations;
+
+		pBlock->m_pNext = m_pOverflow;
+		pBlock->m_capacity = capacity;
+		pBlock->m_used = 0;
+		m_pOverflow = pBlock;
+		start = ((uintptr_t)((char *)(pBlock) + headerSize) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	}
+
+	const PrimitiveTypes::UInt32 used = (PrimitiveTypes::UInt32)(start + size - (uintptr_t)((char *)(pBlock) + headerSize));
+	m_overflowBytes += used - pBlock->m_used;
+	pBlock->m_used = used;
+	return (void *)(start);
+}
+
+void FrameArena::reset()
+{
+	const PrimitiveTypes::UInt32 frameBytes = m_used + m_overflowBytes;
+	if (frameBytes > m_highWater)
+		m_highWater = frameBytes;
+
+	while (m_pOverflow)
+	{
+		OverflowBlock *pNext = m_pOverflow->m_pNext;
+		free(m_pOverflow);
+		m_pOverflow = pNext;
+	}
+
+	if (m_overflowBytes)
+	{
+		// grow once to what this frame needed, so the same load fits next frame
+		PrimitiveTypes::UInt32 capacity = m_capacity;
+		while (capacity < frameBytes)
+			capacity *= 2;
+		free(m_pBlock);
+		m_pBlock = (char *)(malloc(capacity));
+		m_capacity = capacity;
+		++m_numHeapAllocations;
+	}
+
+	m_used = 0;
+	m_overflowBytes = 0;
+}
+
+namespace Components {
+
+PE_IMPLEMENT_CLASS1(FrameArenaSystem, Component);
+
+FrameArenaSystem *FrameArenaSystem::s_pInstance = NULL;
+
+void FrameArenaSystem::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle handle("FrameArenaSystem", sizeof(FrameArenaSystem));
+	FrameArenaSystem *pSystem = new(handle) FrameArenaSystem(context, arena, handle);
+	pSystem->addDefaultComponents();
+	s_pInstance = pSystem;
+	RootSceneNode::Instance()->addComponent(handle);
+}
+
+FrameArenaSystem::FrameArenaSystem(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself)
+: Component(context, arena, hMyself)
+{
+}
+
+void FrameArenaSystem::addDefaultComponents()
+{
+	Component::addDefaultComponents();
+
+	PE_REGISTER_EVENT_HANDLER(Events::Event_PRE_GATHER_DRAWCALLS, FrameArenaSystem::do_PRE_GATHER_DRAWCALLS);
+}
+
+void FrameArenaSystem::do_PRE_GATHER_DRAWCALLS(Events::Event *pEvt)
+{
+	// frame allocations are done; nothing from this frame is referenced past here
+	FrameArena::EndFrame();
+	if (g_debugFrameArenaStats)
+	{
+		// both stay 0 once the arenas have grown to the steady state load and nothing else allocates
+		PEINFO("Frame arena: %u heap allocations last frame, %u total, %u operator new last frame\n",
+			FrameArena::NumHeapAllocationsLastFrame(), FrameArena::NumHeapAllocations(), FrameArena::NumOperatorNewLastFrame());
+	}
+}
+
+}; // namespace Components
+}; // namespace PE
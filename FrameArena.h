@@ -0,0 +1,115 @@
+#ifndef __PYENGINE_2_0_FRAME_ARENA_H__
+#define __PYENGINE_2_0_FRAME_ARENA_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+#include <new>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "../Events/Component.h"
+
+// Sibling/Children includes
+#include "JobPool.h"
+
+#define PE_FRAME_ARENA_BLOCK_SIZE (64 * 1024) // initial block of each thread's arena
+#define PE_FRAME_ARENA_MAX_THREADS (PE_JOB_POOL_MAX_WORKERS + 2)
+
+// Profiling switch: replaces every form of the global operator new and delete with counting ones, so
+// allocations that bypass the arenas show up in the frame stats. Off by default; set it to 1 only in a
+// debug or profiling configuration that has no other allocator hooks
+#ifndef PE_FRAME_ARENA_COUNT_NEW
+#define PE_FRAME_ARENA_COUNT_NEW 0
+#endif
+
+namespace PE {
+
+// Bump allocator for memory that lives until the end of the frame: scratch arrays such as broadphase candidates.
+// One per thread that asks for it (game thread, job workers), all rewound by EndFrame().
+// Nothing is freed or destructed individually, so only put trivially destructible data here.
+// A frame that does not fit the block spills to the heap; the next EndFrame() grows the block to cover it,
+// so a steady state frame makes no arena heap allocations (see NumHeapAllocations()).
+// NumOperatorNewLastFrame() counts the allocations made around the arenas.
+struct FrameArena
+{
+	// this thread's arena
+	static FrameArena *Current();
+
+	// rewinds every thread's arena; game thread, once per frame, while no jobs are running
+	static void EndFrame();
+
+	// number of EndFrame() calls; memory from the arenas is valid while this has not changed
+	static PrimitiveTypes::UInt32 FrameIndex();
+
+	// heap allocations made by all arenas since start up, and during the last ended frame
+	static PrimitiveTypes::UInt32 NumHeapAllocations();
+	static PrimitiveTypes::UInt32 NumHeapAllocationsLastFrame();
+
+	// global operator new calls during the last ended frame; 0 without PE_FRAME_ARENA_COUNT_NEW
+	static PrimitiveTypes::UInt32 NumOperatorNewLastFrame();
+
+	void *allocate(PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 alignment = 16);
+
+	template <typename T>
+	T *create()
+	{
+		return new(allocate(sizeof(T))) T();
+	}
+
+	PrimitiveTypes::UInt32 getHighWater() const { return m_highWater; }
+
+private:
+	FrameArena();
+	void reset();
+	void *allocateOverflow(PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 alignment);
+
+	struct OverflowBlock
+	{
+		OverflowBlock *m_pNext;
+		PrimitiveTypes::UInt32 m_capacity;
+		PrimitiveTypes::UInt32 m_used;
+	};
+
+	char *m_pBlock;
+	PrimitiveTypes::UInt32 m_capacity;
+	PrimitiveTypes::UInt32 m_used;
+	PrimitiveTypes::UInt32 m_highWater; // bytes, including overflow, of the biggest frame so far
+
+	OverflowBlock *m_pOverflow; // this frame's spills, freed by reset()
+	PrimitiveTypes::UInt32 m_overflowBytes;
+
+	PrimitiveTypes::UInt32 m_numHeapAllocations;
+};
+
+namespace Components {
+
+// Ends the frame of every FrameArena on Event_PRE_GATHER_DRAWCALLS: game thread, after the scene update,
+// with no jobs running. Constructed at scene init, with the DebugRenderer
+struct FrameArenaSystem : public Component
+{
+	PE_DECLARE_CLASS(FrameArenaSystem);
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static FrameArenaSystem *Instance() { return s_pInstance; }
+
+	// Constructor -------------------------------------------------------------
+	FrameArenaSystem(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself);
+
+	// Component ---------------------------------------------------------------
+	virtual void addDefaultComponents();
+
+	PE_DECLARE_IMPLEMENT_EVENT_HANDLER_WRAPPER(do_PRE_GATHER_DRAWCALLS);
+	virtual void do_PRE_GATHER_DRAWCALLS(Events::Event *pEvt);
+
+private:
+	static FrameArenaSystem *s_pInstance;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
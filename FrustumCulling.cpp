@@ -0,0 +1,224 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "FrustumCulling.h"
+
+namespace PE {
+namespace Components {
+
+MultiViewCuller::MultiViewCuller()
+: m_collectStats(true)
+, m_numViews(1)
+, m_zOnlyView(PE_CULLING_VIEW_MAIN)
+{
+	// until the camera sets view 0 nothing is rejected
+	for (int ip = 0; ip < 6; ++ip)
+	{
+		for (int iv = 0; iv < PE_MAX_CULLING_VIEWS; ++iv)
+		{
+			m_planeA[ip][iv] = m_planeB[ip][iv] = m_planeC[ip][iv] = 0.0f;
+			m_planeD[ip][iv] = 1.0f;
+		}
+	}
+}
+
+MultiViewCuller &MultiViewCuller::FrameViews()
+{
+	static MultiViewCuller s_frameViews;
+	return s_frameViews;
+}
+
+void MultiViewCuller::buildFrustumPlanes(const Matrix4x4 &viewProjection, Plane *pPlanes)
+{
+	Matrix4x4 mvp = viewProjection;
+	mvp = mvp.transpose();
+
+	Vector3 m1j = mvp.getU();    // m11, m12, m13
+	Vector3 m2j = mvp.getV();    // m21, m22, m23
+	Vector3 m3j = mvp.getN();    // m31, m32, m33
+	Vector3 m4j = mvp.getPos();  // m41, m42, m43
+
+	// Left clipping plane
+	pPlanes[0].buildPlaneByPlus(m4j, m1j, mvp.m[3][3], mvp.m[3][0]);
+
+	// Right clipping plane
+	pPlanes[1].buildPlaneByMinus(m4j, m1j, mvp.m[3][3], mvp.m[3][0]);
+
+	// Top clipping plane
+	pPlanes[2].buildPlaneByMinus(m4j, m2j, mvp.m[3][3], mvp.m[3][1]);
+
+	// Bottom clipping plane
+	pPlanes[3].buildPlaneByPlus(m4j, m2j, mvp.m[3][3], mvp.m[3][1]);
+
+	// Near clipping plane
+	pPlanes[4].buildPlaneByPlus(m4j, m3j, mvp.m[3][3], mvp.m[3][2]);
+
+	// Far clipping plane
+	pPlanes[5].buildPlaneByMinus(m4j, m3j, mvp.m[3][3], mvp.m[3][2]);
+
+	for (int ip = 0; ip < 6; ++ip)
+		pPlanes[ip].normalizeLength();
+}
+
+int MultiViewCuller::addView(const Plane *pPlanes)
+{
+	if (m_numViews >= PE_MAX_CULLING_VIEWS)
+		return -1;
+	setView(m_numViews, pPlanes);
+	return m_numViews++;
+}
+
+int MultiViewCuller::addView(const Matrix4x4 &viewProjection)
+{
+	Plane planes[6];
+	buildFrustumPlanes(viewProjection, planes);
+	return addView(planes);
+}
+
+void MultiViewCuller::setView(int iView, const Plane *pPlanes)
+{
+	PEASSERT(iView >= 0 && iView < PE_MAX_CULLING_VIEWS, "Invalid culling view index");
+	for (int ip = 0; ip < 6; ++ip)
+	{
+		m_planeA[ip][iView] = pPlanes[ip].a;
+		m_planeB[ip][iView] = pPlanes[ip].b;
+		m_planeC[ip][iView] = pPlanes[ip].c;
+		m_planeD[ip][iView] = pPlanes[ip].d;
+	}
+}
+
+void MultiViewCuller::setView(int iView, const Matrix4x4 &viewProjection)
+{
+	Plane planes[6];
+	buildFrustumPlanes(viewProjection, planes);
+	setView(iView, planes);
+}
+
+void MultiViewCuller::setNumViews(int numViews)
+{
+	PEASSERT(numViews >= 1 && numViews <= PE_MAX_CULLING_VIEWS, "Invalid number of culling views");
+	m_numViews = numViews;
+	if (m_zOnlyView >= m_numViews)
+		m_zOnlyView = PE_CULLING_VIEW_MAIN;
+}
+
+PrimitiveTypes::Float32 MultiViewCuller::planeRadius(int iPlane, int iView, const Vector3 &halfU, const Vector3 &halfV, const Vector3 &halfN) const
+{
+	const PrimitiveTypes::Float32 a = m_planeA[iPlane][iView];
+	const PrimitiveTypes::Float32 b = m_planeB[iPlane][iView];
+	const PrimitiveTypes::Float32 c = m_planeC[iPlane][iView];
+	return fabsf(a * halfU.m_x + b * halfU.m_y + c * halfU.m_z) +
+		fabsf(a * halfV.m_x + b * halfV.m_y + c * halfV.m_z) +
+		fabsf(a * halfN.m_x + b * halfN.m_y + c * halfN.m_z);
+}
+
+PrimitiveTypes::UInt32 MultiViewCuller::testViews(int firstView, const Vector3 &center, const Vector3 &halfU, const Vector3 &halfV, const Vector3 &halfN) const
+{
+	PrimitiveTypes::UInt32 mask = getAllViewsMask() & ~((1u << firstView) - 1);
+
+	for (int ip = 0; ip < 6 && mask; ++ip)
+	{
+		const PrimitiveTypes::Float32 *a = m_planeA[ip];
+		const PrimitiveTypes::Float32 *b = m_planeB[ip];
+		const PrimitiveTypes::Float32 *c = m_planeC[ip];
+		const PrimitiveTypes::Float32 *d = m_planeD[ip];
+
+		for (int iv = firstView; iv < m_numViews; ++iv)
+		{
+			// box is outside when its center is further behind the plane than its projected radius
+			PrimitiveTypes::Float32 dist = a[iv] * center.m_x + b[iv] * center.m_y + c[iv] * center.m_z + d[iv];
+			PrimitiveTypes::Float32 radius =
+				fabsf(a[iv] * halfU.m_x + b[iv] * halfU.m_y + c[iv] * halfU.m_z) +
+				fabsf(a[iv] * halfV.m_x + b[iv] * halfV.m_y + c[iv] * halfV.m_z) +
+				fabsf(a[iv] * halfN.m_x + b[iv] * halfN.m_y + c[iv] * halfN.m_z);
+
+			if (dist + radius < 0.0f)
+				mask &= ~(1u << iv);
+		}
+	}
+	return mask;
+}
+
+PrimitiveTypes::UInt32 MultiViewCuller::testOBB(const Vector3 &center, const Vector3 &halfU, const Vector3 &halfV, const Vector3 &halfN) const
+{
+	return testViews(0, center, halfU, halfV, halfN);
+}
+
+PrimitiveTypes::UInt32 MultiViewCuller::testOBB(const Matrix4x4 &world, const Vector3 &localMin, const Vector3 &localMax) const
+{
+	const Vector3 localCenter = (localMin + localMax) * 0.5f;
+	const Vector3 localHalf = (localMax - localMin) * 0.5f;
+
+	const Vector3 center = world * localCenter;
+	return testOBB(center, world.getU() * localHalf.m_x, world.getV() * localHalf.m_y, world.getN() * localHalf.m_z);
+}
+
+PrimitiveTypes::UInt32 MultiViewCuller::testOBB(const Vector3 &center, const Vector3 &halfU, const Vector3 &halfV, const Vector3 &halfN,
+	CullingState &state, PrimitiveTypes::Float32 *pNearDistance)
+{
+	const int iv = PE_CULLING_VIEW_MAIN;
+	// NULL while a pass repeats tests already counted this frame
+	CullingStats *pStats = m_collectStats ? &m_frameStats : NULL;
+	if (pStats)
+		++pStats->m_numBoxesTested;
+
+	if (pNearDistance)
+		*pNearDistance = planeDistance(4, iv, center);
+
+	bool rejected = false;
+
+	// the plane that rejected the box last frame is the most likely to reject it again
+	const int iFirstPlane = state.m_lastRejectPlane;
+	for (int i = -1; i < 6 && !rejected; ++i)
+	{
+		const int ip = (i < 0) ? iFirstPlane : i;
+		if (ip < 0 || (i >= 0 && ip == iFirstPlane))
+			continue;
+
+		if (pStats)
+			++pStats->m_numPlanesEvaluated;
+
+		const PrimitiveTypes::Float32 dist = planeDistance(ip, iv, center);
+		const PrimitiveTypes::Float32 radius = planeRadius(ip, iv, halfU, halfV, halfN);
+
+		if (dist + radius < 0.0f)
+		{
+			rejected = true;
+			if (pStats && ip == iFirstPlane)
+				++pStats->m_numCoherencyRejects;
+			state.m_lastRejectPlane = ip;
+		}
+	}
+
+	PrimitiveTypes::UInt32 mask = rejected ? 0 : (1u << iv);
+	if (m_numViews > 1)
+		mask |= testViews(iv + 1, center, halfU, halfV, halfN);
+	return mask;
+}
+
+PrimitiveTypes::UInt32 MultiViewCuller::testOBB(const Matrix4x4 &world, const Vector3 &localMin, const Vector3 &localMax,
+	CullingState &state, PrimitiveTypes::Float32 *pNearDistance)
+{
+	const Vector3 localCenter = (localMin + localMax) * 0.5f;
+	const Vector3 localHalf = (localMax - localMin) * 0.5f;
+
+	const Vector3 center = world * localCenter;
+	return testOBB(center, world.getU() * localHalf.m_x, world.getV() * localHalf.m_y, world.getN() * localHalf.m_z,
+		state, pNearDistance);
+}
+
+void MultiViewCuller::endFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_frameStats.reset();
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,115 @@
+#ifndef __PYENGINE_2_0_FRUSTUM_CULLING_H__
+#define __PYENGINE_2_0_FRUSTUM_CULLING_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Math/Plane.h"
+
+// Sibling/Children includes
+
+#define PE_MAX_CULLING_VIEWS 8      // bits used in MeshInstance::m_visibilityMask
+#define PE_CULLING_VIEW_MAIN 0      // always the active camera
+
+namespace PE {
+namespace Components {
+
+// Per-instance state kept between frames for the main view test
+struct CullingState
+{
+	CullingState() : m_lastRejectPlane(-1) {}
+
+	int m_lastRejectPlane; // plane that rejected the box last time; tested first next frame
+};
+
+// Counters for the main view test, kept per frame
+struct CullingStats
+{
+	CullingStats() { reset(); }
+	void reset() { m_numBoxesTested = m_numPlanesEvaluated = m_numCoherencyRejects = 0; }
+
+	PrimitiveTypes::UInt32 m_numBoxesTested;
+	PrimitiveTypes::UInt32 m_numPlanesEvaluated;
+	PrimitiveTypes::UInt32 m_numCoherencyRejects; // rejected by the plane cached from last frame
+};
+
+// Tests bounds against several frustums at once (main camera, shadow cascades, minimap, ...)
+// and returns one bit per view. Planes are stored plane-major so the inner loop runs over views
+// and the box is only transformed once for all of them.
+struct MultiViewCuller
+{
+	MultiViewCuller();
+
+	// Frame-wide view set used by SingleHandler_DRAW. View 0 is set from the active camera every gather,
+	// other views are registered by their owners with addView() and refreshed with setView().
+	static MultiViewCuller &FrameViews();
+
+	// Builds 6 inward facing, unit length planes (left, right, top, bottom, near, far) from a projection * view matrix
+	static void buildFrustumPlanes(const Matrix4x4 &viewProjection, Plane *pPlanes);
+
+	int addView(const Plane *pPlanes);                 // returns view index or -1 if all slots are used
+	int addView(const Matrix4x4 &viewProjection);
+	void setView(int iView, const Plane *pPlanes);
+	void setView(int iView, const Matrix4x4 &viewProjection);
+	void setNumViews(int numViews);
+
+	PrimitiveTypes::UInt32 getAllViewsMask() const { return (PrimitiveTypes::UInt32)((1ull << m_numViews) - 1); }
+
+	// Oriented box given by center and three half-axis vectors
+	PrimitiveTypes::UInt32 testOBB(const Vector3 &center, const Vector3 &halfU, const Vector3 &halfV, const Vector3 &halfN) const;
+
+	// Local AABB (min/max) placed by a world matrix
+	PrimitiveTypes::UInt32 testOBB(const Matrix4x4 &world, const Vector3 &localMin, const Vector3 &localMax) const;
+
+	// Same as testOBB() but the main view starts with the plane that rejected the box last frame.
+	// Optionally returns the signed distance of the box center to the near plane.
+	PrimitiveTypes::UInt32 testOBB(const Vector3 &center, const Vector3 &halfU, const Vector3 &halfV, const Vector3 &halfN,
+		CullingState &state, PrimitiveTypes::Float32 *pNearDistance);
+
+	PrimitiveTypes::UInt32 testOBB(const Matrix4x4 &world, const Vector3 &localMin, const Vector3 &localMax,
+		CullingState &state, PrimitiveTypes::Float32 *pNearDistance);
+
+	// Call once per frame; moves the counters to m_lastFrameStats
+	void endFrame();
+
+	// off while a pass repeats tests already counted this frame (Z-only)
+	void setCollectStats(bool collectStats) { m_collectStats = collectStats; }
+
+	const CullingStats &getLastFrameStats() const { return m_lastFrameStats; }
+
+private:
+	PrimitiveTypes::UInt32 testViews(int firstView, const Vector3 &center, const Vector3 &halfU, const Vector3 &halfV, const Vector3 &halfN) const;
+
+	PrimitiveTypes::Float32 planeDistance(int iPlane, int iView, const Vector3 &p) const
+	{
+		return m_planeA[iPlane][iView] * p.m_x + m_planeB[iPlane][iView] * p.m_y + m_planeC[iPlane][iView] * p.m_z + m_planeD[iPlane][iView];
+	}
+
+	PrimitiveTypes::Float32 planeRadius(int iPlane, int iView, const Vector3 &halfU, const Vector3 &halfV, const Vector3 &halfN) const;
+
+	bool m_collectStats;
+
+public:
+	// Data --------------------------------------------------------------------
+	PrimitiveTypes::Float32 m_planeA[6][PE_MAX_CULLING_VIEWS];
+	PrimitiveTypes::Float32 m_planeB[6][PE_MAX_CULLING_VIEWS];
+	PrimitiveTypes::Float32 m_planeC[6][PE_MAX_CULLING_VIEWS];
+	PrimitiveTypes::Float32 m_planeD[6][PE_MAX_CULLING_VIEWS];
+	int m_numViews;
+	int m_zOnlyView; // view whose bit decides visibility in the Z-only pass
+
+	CullingStats m_frameStats;
+	CullingStats m_lastFrameStats;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
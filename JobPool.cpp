@@ -0,0 +1,167 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "JobPool.h"
+
+namespace PE {
+
+static thread_local bool s_isJobPoolWorker = false;
+
+JobPool *JobPool::Instance()
+{
+	static JobPool s_pool;
+	return &s_pool;
+}
+
+JobPool::JobPool()
+: m_numWorkers(0)
+, m_pJob(NULL)
+, m_generation(0)
+, m_quit(false)
+{
+}
+
+JobPool::~JobPool()
+{
+	// the pool is a function static; threads still running at exit would terminate the process
+	stop();
+}
+
+void JobPool::start(int numWorkers)
+{
+	if (m_numWorkers)
+		return;
+
+	if (numWorkers < 0)
+	{
+		numWorkers = (int)(std::thread::hardware_concurrency()) - 1;
+		if (numWorkers < 0)
+			numWorkers = 0;
+	}
+	if (numWorkers > PE_JOB_POOL_MAX_WORKERS)
+		numWorkers = PE_JOB_POOL_MAX_WORKERS;
+
+	m_quit = false;
+	for (int i = 0; i < numWorkers; ++i)
+		m_workers[i] = std::thread(&JobPool::workerMain, this);
+	m_numWorkers = numWorkers;
+}
+
+void JobPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+
+	for (int i = 0; i < m_numWorkers; ++i)
+		m_workers[i].join();
+	m_numWorkers = 0;
+}
+
+bool JobPool::isWorkerThread() const
+{
+	return s_isJobPoolWorker;
+}
+
+void JobPool::runChunks(Job &job)
+{
+	const int count = job.m_count;
+	const int grainSize = job.m_grainSize;
+	for (;;)
+	{
+		const int begin = job.m_nextItem.fetch_add(grainSize);
+		if (begin >= count)
+			break;
+		const int end = begin + grainSize < count ? begin + grainSize : count;
+
+		job.m_func(job.m_pUserData, begin, end);
+
+		if (job.m_numItemsDone.fetch_add(end - begin) + (end - begin) >= count)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_done.notify_all();
+		}
+	}
+}
+
+void JobPool::workerMain()
+{
+	s_isJobPoolWorker = true;
+	PrimitiveTypes::UInt32 seenGeneration = 0;
+
+	for (;;)
+	{
+		Job *pJob;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (!m_quit && seenGeneration == m_generation)
+				m_wake.wait(lock);
+			if (m_quit)
+				return;
+			seenGeneration = m_generation;
+
+			// woken late: the job of this generation may be finished already
+			pJob = m_pJob;
+			if (!pJob)
+				continue;
+			++pJob->m_numWorkersInside;
+		}
+
+		runChunks(*pJob);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			--pJob->m_numWorkersInside;
+		}
+		m_done.notify_all();
+	}
+}
+
+void JobPool::parallelFor(int count, int grainSize, RangeFunction func, void *pUserData)
+{
+	if (count <= 0)
+		return;
+	if (grainSize < 1)
+		grainSize = 1;
+
+	// nested calls and single chunks run inline
+	if (m_numWorkers == 0 || s_isJobPoolWorker || count <= grainSize)
+	{
+		func(pUserData, 0, count);
+		return;
+	}
+
+	std::lock_guard<std::mutex> submitLock(m_submitMutex);
+
+	Job job;
+	job.m_func = func;
+	job.m_pUserData = pUserData;
+	job.m_count = count;
+	job.m_grainSize = grainSize;
+	job.m_nextItem = 0;
+	job.m_numItemsDone = 0;
+	job.m_numWorkersInside = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pJob = &job;
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	runChunks(job);
+
+	// the job is on this stack, so wait for the workers to leave it as well as for the items
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (job.m_numItemsDone.load() < count || job.m_numWorkersInside > 0)
+		m_done.wait(lock);
+	m_pJob = NULL;
+}
+
+}; // namespace PE
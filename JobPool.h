@@ -0,0 +1,75 @@
+#ifndef __PYENGINE_2_0_JOB_POOL_H__
+#define __PYENGINE_2_0_JOB_POOL_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+
+// Sibling/Children includes
+
+#define PE_JOB_POOL_MAX_WORKERS 15
+
+namespace PE {
+
+// Fixed set of worker threads for frame work that splits into independent ranges.
+// parallelFor() blocks; the calling thread works on the range too, so with no workers it runs serially.
+struct JobPool
+{
+	typedef void (*RangeFunction)(void *pUserData, int begin, int end);
+
+	static JobPool *Instance();
+
+	// numWorkers < 0 picks hardware threads - 1
+	void start(int numWorkers = -1);
+	void stop();
+
+	int getNumWorkers() const { return m_numWorkers; }
+	bool isWorkerThread() const;
+
+	// Calls func over [0, count) in chunks of at most grainSize items.
+	// Frame work on the main thread only; background threads (AsyncMeshLoader) do their own work serially
+	void parallelFor(int count, int grainSize, RangeFunction func, void *pUserData);
+
+private:
+	// One parallelFor() call; lives on the submitting thread's stack until every worker that took it has left
+	struct Job
+	{
+		RangeFunction m_func;
+		void *m_pUserData;
+		int m_count;
+		int m_grainSize;
+		std::atomic<int> m_nextItem;
+		std::atomic<int> m_numItemsDone;
+		int m_numWorkersInside; // guarded by m_mutex
+	};
+
+	JobPool();
+	~JobPool();
+	void workerMain();
+	void runChunks(Job &job);
+
+	std::thread m_workers[PE_JOB_POOL_MAX_WORKERS];
+	int m_numWorkers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	std::mutex m_submitMutex; // one parallelFor at a time
+
+	Job *m_pJob; // current job, NULL between parallelFor() calls; guarded by m_mutex
+	PrimitiveTypes::UInt32 m_generation;
+	bool m_quit;
+};
+
+}; // namespace PE
+
+#endif
@@ -0,0 +1,207 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "MappedFile.h"
+
+namespace PE {
+
+MappedFile::MappedFile()
+: m_pData(NULL)
+, m_size(0)
+#if defined(_WIN32)
+, m_hFile(NULL)
+, m_hMapping(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const char *path)
+{
+	close();
+
+#if defined(_WIN32)
+	HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	const void *pData = hMapping ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (!pData)
+	{
+		if (hMapping)
+			CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return false;
+	}
+
+	m_hFile = hFile;
+	m_hMapping = hMapping;
+	m_size = (PrimitiveTypes::UInt64)(size.QuadPart);
+	m_pData = pData;
+#else
+	const int fd = ::open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void *pData = mmap(NULL, (size_t)(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // the mapping keeps the file referenced
+	if (pData == MAP_FAILED)
+		return false;
+
+	m_size = (PrimitiveTypes::UInt64)(st.st_size);
+	m_pData = pData;
+#endif
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (!m_pData)
+		return;
+
+#if defined(_WIN32)
+	UnmapViewOfFile(m_pData);
+	CloseHandle((HANDLE)(m_hMapping));
+	CloseHandle((HANDLE)(m_hFile));
+	m_hMapping = m_hFile = NULL;
+#else
+	munmap((void *)(m_pData), (size_t)(m_size));
+#endif
+	m_pData = NULL;
+	m_size = 0;
+}
+
+bool MappedFile::GetFileInfo(const char *path, PrimitiveTypes::UInt64 &size, PrimitiveTypes::UInt64 &modifiedTime)
+{
+	struct stat st;
+	if (stat(path, &st) != 0)
+		return false;
+	size = (PrimitiveTypes::UInt64)(st.st_size);
+	modifiedTime = (PrimitiveTypes::UInt64)(st.st_mtime);
+	return true;
+}
+
+PrimitiveTypes::UInt64 MappedFile::HashBytes(const void *pData, PrimitiveTypes::UInt64 size)
+{
+	const unsigned char *p = (const unsigned char *)(pData);
+	PrimitiveTypes::UInt64 h = 14695981039346656037ull;
+	for (PrimitiveTypes::UInt64 i = 0; i < size; ++i)
+	{
+		h ^= p[i];
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+bool MappedFile::GetSourceInfo(const char *sourcePath, BakedSource &source)
+{
+	if (!GetFileInfo(sourcePath, source.m_size, source.m_modifiedTime))
+		return false;
+
+	MappedFile file;
+	if (!file.open(sourcePath))
+		return false;
+	source.m_hash = HashBytes(file.getData(), file.getSize());
+	return true;
+}
+
+// rewrites the stored source time of a baked file whose source was touched without changing
+static bool updateSourceTime(const char *path, PrimitiveTypes::UInt32 sourceOffset, PrimitiveTypes::UInt64 sourceTime)
+{
+	FILE *f = fopen(path, "r+b");
+	if (!f)
+		return false;
+
+	const bool ok = fseek(f, (long)(sourceOffset + offsetof(BakedSource, m_modifiedTime)), SEEK_SET) == 0
+		&& fwrite(&sourceTime, sizeof(sourceTime), 1, f) == 1;
+	fclose(f);
+	return ok;
+}
+
+bool MappedFile::openBaked(const char *path, const char *sourcePath, PrimitiveTypes::UInt32 magic, PrimitiveTypes::UInt32 version,
+	PrimitiveTypes::UInt32 headerSize, PrimitiveTypes::UInt32 sourceOffset)
+{
+	if (!open(path))
+		return false;
+
+	PrimitiveTypes::UInt32 prefix[3]; // magic, version, file size
+	BakedSource stored;
+	if (m_size < headerSize)
+	{
+		close();
+		return false;
+	}
+	memcpy(prefix, m_pData, sizeof(prefix));
+	memcpy(&stored, (const char *)(m_pData) + sourceOffset, sizeof(stored));
+
+	PrimitiveTypes::UInt64 sourceSize = 0, sourceTime = 0;
+	if (prefix[0] != magic || prefix[1] != version || prefix[2] != m_size
+		|| !GetFileInfo(sourcePath, sourceSize, sourceTime) || sourceSize != stored.m_size)
+	{
+		close();
+		return false;
+	}
+
+	if (sourceTime == stored.m_modifiedTime)
+		return true;
+
+	// touched but maybe not changed: the content decides
+	{
+		MappedFile source;
+		if (!source.open(sourcePath) || HashBytes(source.getData(), source.getSize()) != stored.m_hash)
+		{
+			close();
+			return false;
+		}
+	}
+
+	// same content: store the new time so later opens skip the hash. The mapping is
+	// opened without write sharing, so it is dropped while the header is patched
+	const PrimitiveTypes::UInt64 fileSize = m_size;
+	close();
+	if (!updateSourceTime(path, sourceOffset, sourceTime) || !open(path) || m_size != fileSize)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+}; // namespace PE
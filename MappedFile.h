@@ -0,0 +1,68 @@
+#ifndef __PYENGINE_2_0_MAPPED_FILE_H__
+#define __PYENGINE_2_0_MAPPED_FILE_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+// Source asset a baked file was made from, stored in the baked file's header
+struct BakedSource
+{
+	PrimitiveTypes::UInt64 m_size;
+	PrimitiveTypes::UInt64 m_modifiedTime;
+	PrimitiveTypes::UInt64 m_hash;
+};
+
+// Read only memory mapping of a whole file. Unmapped on close() or destruction
+struct MappedFile
+{
+	MappedFile();
+	~MappedFile();
+
+	bool open(const char *path);
+	void close();
+
+	bool isOpen() const { return m_pData != NULL; }
+	const void *getData() const { return m_pData; }
+	PrimitiveTypes::UInt64 getSize() const { return m_size; }
+
+	// size and modification time without opening the file; false if it does not exist
+	static bool GetFileInfo(const char *path, PrimitiveTypes::UInt64 &size, PrimitiveTypes::UInt64 &modifiedTime);
+
+	// FNV-1a, used to validate baked files against their sources
+	static PrimitiveTypes::UInt64 HashBytes(const void *pData, PrimitiveTypes::UInt64 size);
+
+	// Size, time and content hash of sourcePath, to be stored when baking from it. false when it can't be read
+	static bool GetSourceInfo(const char *sourcePath, BakedSource &source);
+
+	// Maps a file baked from sourcePath (BinaryMesh, CollisionSidecar). The file starts with UInt32 magic, version
+	// and file size and has its BakedSource at sourceOffset. It is used when the source size and time match;
+	// otherwise the source is hashed, and on a match the new time is written back so the hash runs once.
+	// false (and closed) when missing, malformed or stale; format specific checks are left to the caller
+	bool openBaked(const char *path, const char *sourcePath, PrimitiveTypes::UInt32 magic, PrimitiveTypes::UInt32 version,
+		PrimitiveTypes::UInt32 headerSize, PrimitiveTypes::UInt32 sourceOffset);
+
+private:
+	MappedFile(const MappedFile &);
+	MappedFile &operator=(const MappedFile &);
+
+	const void *m_pData;
+	PrimitiveTypes::UInt64 m_size;
+#if defined(_WIN32)
+	void *m_hFile;
+	void *m_hMapping;
+#endif
+};
+
+}; // namespace PE
+
+#endif
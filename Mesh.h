@@ -23,6 +23,9 @@
 
 // Sibling/Children includes
 
+// max number of entries in Mesh::m_lods that take part in distance based LOD selection
+#define PE_MAX_MESH_LOD_COUNT 4
+
 namespace PE {
 struct MaterialSetCPU;
 namespace Components {
@@ -82,6 +85,10 @@ struct Mesh : public Component
 	Handle m_hTangentBufferCPU;
 
 	Handle m_hSkinWeightsCPU;
+	Handle m_hSkinJointBounds; // SkinJointBounds built from m_hSkinWeightsCPU at load
+	Handle m_hSkinningStreams; // SkinningStreams for CpuSkinning, invalid until CpuSkinning::AcquireStreams() and after MeshCpuResidency::release()
+	Handle m_hCollisionShape; // CollisionShape shared by the PhysicsManagers of all instances
+	Handle m_hCpuResidency; // MeshCpuResidency: whether the CPU vertex buffers above are kept after load
 
 	Array<Handle> m_additionalShaderValues;
 
@@ -93,7 +100,12 @@ struct Mesh : public Component
 
 	Array<Handle, 1> m_instances; // special cahce of instances
 	Array<Handle> m_lods;
+	// projected size (bounding radius / half view height) below which m_lods[i] is used.
+	// if empty, SH_DRAW falls back to its default table
+	PEStaticVector<PrimitiveTypes::Float32, PE_MAX_MESH_LOD_COUNT> m_lodScreenSizes;
     int m_numVisibleInstances;
+	// visible instances per LOD bucket, filled by the culling pass (0 = this mesh, i = m_lods[i-1])
+	int m_numVisibleInstancesPerLod[PE_MAX_MESH_LOD_COUNT + 1];
 	
 	Handle m_hAnimationSetGPU; // reference to animation stored in gpu buffer
 	
@@ -0,0 +1,196 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Geometry/MeshCPU/MeshCPU.h"
+#include "PrimeEngine/Geometry/IndexBufferCPU/IndexBufferCPU.h"
+
+// Sibling/Children includes
+#include "MeshCpuResidency.h"
+#include "Mesh.h"
+#include "BinaryMesh.h"
+#include "CpuSkinning.h"
+
+namespace PE {
+namespace Components {
+
+PrimitiveTypes::UInt32 MeshCpuResidency::s_releasedBytes = 0;
+
+// keep requests by asset hash; a colliding hash only keeps buffers that could have been released
+static PrimitiveTypes::UInt64 s_keepHashes[PE_MESH_CPU_MAX_KEEP_REQUESTS];
+static PrimitiveTypes::UInt32 s_keepFlags[PE_MESH_CPU_MAX_KEEP_REQUESTS];
+static int s_numKeepRequests = 0;
+
+template <typename T>
+static PrimitiveTypes::UInt32 releaseBuffer(Handle &h)
+{
+	if (!h.isValid())
+		return 0;
+
+	T *pBuffer = h.getObject<T>();
+	const PrimitiveTypes::UInt32 bytes = pBuffer->m_values.m_size * sizeof(PrimitiveTypes::Float32);
+	pBuffer->m_values.reset(0); // clear memory
+	h.release();
+	h = Handle();
+	return bytes;
+}
+
+// Parts of a reparsed MeshCPU that the Mesh already has
+static void releaseIndexBuffer(Handle &h)
+{
+	if (!h.isValid())
+		return;
+
+	IndexBufferCPU *pIndices = h.getObject<IndexBufferCPU>();
+	for (PrimitiveTypes::UInt32 ir = 0; ir < pIndices->m_indexRanges.m_size; ++ir)
+	{
+		IndexRange &range = pIndices->m_indexRanges[ir];
+		for (PrimitiveTypes::UInt32 is = 0; is < range.m_boneSegments.m_size; ++is)
+			range.m_boneSegments[is].m_boneSegmentBones.reset(0);
+		range.m_boneSegments.reset(0);
+	}
+	pIndices->m_indexRanges.reset(0);
+	pIndices->m_values.reset(0);
+	h.release();
+	h = Handle();
+}
+
+static void releaseSkinWeights(Handle &h)
+{
+	if (!h.isValid())
+		return;
+
+	SkinWeightsCPU *pWeights = h.getObject<SkinWeightsCPU>();
+	for (PrimitiveTypes::UInt32 iv = 0; iv < pWeights->m_weightsPerVertex.m_size; ++iv)
+		pWeights->m_weightsPerVertex[iv].reset(0);
+	pWeights->m_weightsPerVertex.reset(0);
+	h.release();
+	h = Handle();
+}
+
+MeshCpuResidency::MeshCpuResidency(PE::GameContext &context, PE::MemoryArena arena, const char *sourcePath, const AssetId &id, PrimitiveTypes::UInt32 keepFlags)
+: m_keepFlags(keepFlags)
+, m_resident(true)
+, m_numReloads(0)
+, m_pContext(&context)
+, m_arena(arena)
+{
+	strncpy(m_sourcePath, sourcePath, sizeof(m_sourcePath) - 1);
+	m_sourcePath[sizeof(m_sourcePath) - 1] = '\0';
+	snprintf(m_asset, sizeof(m_asset), "%s", id.m_asset);
+	snprintf(m_package, sizeof(m_package), "%s", id.m_package);
+}
+
+void MeshCpuResidency::SetKeepFlags(const AssetId &id, PrimitiveTypes::UInt32 keepFlags)
+{
+	for (int i = 0; i < s_numKeepRequests; ++i)
+	{
+		if (s_keepHashes[i] == id.m_hash)
+		{
+			s_keepFlags[i] |= keepFlags;
+			return;
+		}
+	}
+
+	PEASSERT(s_numKeepRequests < PE_MESH_CPU_MAX_KEEP_REQUESTS, "Too many mesh CPU keep requests");
+	s_keepHashes[s_numKeepRequests] = id.m_hash;
+	s_keepFlags[s_numKeepRequests] = keepFlags;
+	++s_numKeepRequests;
+}
+
+PrimitiveTypes::UInt32 MeshCpuResidency::GetKeepFlags(const AssetId &id)
+{
+	for (int i = 0; i < s_numKeepRequests; ++i)
+	{
+		if (s_keepHashes[i] == id.m_hash)
+			return s_keepFlags[i];
+	}
+	return 0;
+}
+
+void MeshCpuResidency::ApplyAfterLoad(PE::GameContext &context, PE::MemoryArena arena, Mesh *pMesh, const char *sourcePath, const AssetId &id)
+{
+	PE::Handle hResidency("MeshCpuResidency", sizeof(MeshCpuResidency));
+	MeshCpuResidency *pResidency = new(hResidency) MeshCpuResidency(context, arena, sourcePath, id, GetKeepFlags(id));
+	pMesh->m_hCpuResidency = hResidency;
+
+	if (!pResidency->m_keepFlags)
+		pResidency->release(pMesh);
+}
+
+bool MeshCpuResidency::Acquire(Mesh *pMesh)
+{
+	if (!pMesh->m_hCpuResidency.isValid())
+		return pMesh->m_hPositionBufferCPU.isValid(); // loaded before the policy, or generated
+	return pMesh->m_hCpuResidency.getObject<MeshCpuResidency>()->acquire(pMesh);
+}
+
+bool MeshCpuResidency::acquire(Mesh *pMesh)
+{
+	if (m_resident)
+		return true;
+
+	BinaryMesh binaryMesh;
+	if (binaryMesh.open(m_sourcePath))
+	{
+		binaryMesh.fillVertexBuffers(*m_pContext, m_arena, pMesh->m_hPositionBufferCPU, pMesh->m_hNormalBufferCPU,
+			pMesh->m_hTangentBufferCPU, pMesh->m_hTexCoordBufferCPU);
+		binaryMesh.close();
+	}
+	else if (!reloadFromSource(pMesh))
+	{
+		return false;
+	}
+
+	m_resident = true;
+	++m_numReloads;
+	PEINFO("MeshCpuResidency: reloaded CPU vertex buffers of %s (%d times)\n", pMesh->m_meshFileName, m_numReloads);
+	return true;
+}
+
+void MeshCpuResidency::release(Mesh *pMesh)
+{
+	if (!m_resident)
+		return;
+
+	s_releasedBytes += releaseBuffer<PositionBufferCPU>(pMesh->m_hPositionBufferCPU);
+	s_releasedBytes += releaseBuffer<NormalBufferCPU>(pMesh->m_hNormalBufferCPU);
+	s_releasedBytes += releaseBuffer<TangentBufferCPU>(pMesh->m_hTangentBufferCPU);
+	s_releasedBytes += releaseBuffer<TexCoordBufferCPU>(pMesh->m_hTexCoordBufferCPU);
+
+	// built from the buffers above; CpuSkinning::AcquireStreams() rebuilds them after acquire()
+	if (pMesh->m_hSkinningStreams.isValid())
+	{
+		s_releasedBytes += pMesh->m_hSkinningStreams.getObject<SkinningStreams>()->clear();
+		pMesh->m_hSkinningStreams.release();
+		pMesh->m_hSkinningStreams = Handle();
+	}
+	m_resident = false;
+}
+
+// No valid binary mesh: parse the .mesha again and keep only its vertex streams
+bool MeshCpuResidency::reloadFromSource(Mesh *pMesh)
+{
+	MeshCPU mcpu(*m_pContext, m_arena);
+	mcpu.ReadMesh(m_asset, m_package, "");
+	if (!mcpu.m_hPositionBufferCPU.isValid())
+		return false;
+
+	pMesh->m_hPositionBufferCPU = mcpu.m_hPositionBufferCPU;
+	pMesh->m_hNormalBufferCPU = mcpu.m_hNormalBufferCPU;
+	pMesh->m_hTangentBufferCPU = mcpu.m_hTangentBufferCPU;
+	pMesh->m_hTexCoordBufferCPU = mcpu.m_hTexCoordBufferCPU;
+
+	releaseIndexBuffer(mcpu.m_hIndexBufferCPU);
+	releaseSkinWeights(mcpu.m_hSkinWeightsCPU);
+	if (mcpu.m_hMaterialSetCPU.isValid())
+		mcpu.m_hMaterialSetCPU.release();
+	return true;
+}
+
+}; // namespace Components
+}; // namespace PE
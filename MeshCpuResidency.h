@@ -0,0 +1,74 @@
+#ifndef __PYENGINE_2_0_MESH_CPU_RESIDENCY_H__
+#define __PYENGINE_2_0_MESH_CPU_RESIDENCY_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+
+// Sibling/Children includes
+#include "AssetHashTable.h"
+
+// reasons to keep a Mesh's CPU vertex buffers after load
+#define PE_MESH_CPU_KEEP_SKINNING  1 // skinning on the CPU from the vertex buffers themselves
+#define PE_MESH_CPU_KEEP_COLLISION 2 // per triangle collision against the positions
+
+#define PE_MESH_CPU_MAX_KEEP_REQUESTS 64
+
+namespace PE {
+namespace Components {
+
+struct Mesh;
+
+// Whether a Mesh keeps m_hPositionBufferCPU, m_hNormalBufferCPU, m_hTangentBufferCPU and m_hTexCoordBufferCPU
+// once MeshManager::getAsset() has uploaded them and baked bounds from them.
+// Without a keep flag they are released and reloaded by acquire() if a debug path wants them: from the binary
+// mesh when it is valid, otherwise by parsing the .mesha again. The SkinningStreams derived from them follow
+// the same policy: built on first use after acquire() (CpuSkinning::AcquireStreams) and dropped by release().
+// Skin weights are never released.
+struct MeshCpuResidency
+{
+	MeshCpuResidency(PE::GameContext &context, PE::MemoryArena arena, const char *sourcePath, const AssetId &id, PrimitiveTypes::UInt32 keepFlags);
+
+	// Flags an asset before it is loaded; flags of several calls are combined
+	static void SetKeepFlags(const AssetId &id, PrimitiveTypes::UInt32 keepFlags);
+	static PrimitiveTypes::UInt32 GetKeepFlags(const AssetId &id);
+
+	// Called by MeshManager::getAsset() when the mesh is done with its CPU buffers
+	static void ApplyAfterLoad(PE::GameContext &context, PE::MemoryArena arena, Mesh *pMesh, const char *sourcePath, const AssetId &id);
+
+	// Makes the CPU vertex buffers of pMesh resident again; they then stay until release().
+	// false if they were released and cannot be reloaded
+	static bool Acquire(Mesh *pMesh);
+
+	bool acquire(Mesh *pMesh);
+	void release(Mesh *pMesh);
+
+	bool isResident() const { return m_resident; }
+
+	// bytes of vertex data released so far, over all meshes and releases
+	static PrimitiveTypes::UInt32 s_releasedBytes;
+
+private:
+	bool reloadFromSource(Mesh *pMesh);
+
+	char m_sourcePath[256];
+	char m_asset[128];
+	char m_package[128];
+	PrimitiveTypes::UInt32 m_keepFlags;
+	bool m_resident;
+	int m_numReloads;
+
+	PE::GameContext *m_pContext;
+	PE::MemoryArena m_arena;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
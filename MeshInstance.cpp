@@ -20,6 +20,8 @@
 // Sibling/Children includes
 #include "MeshInstance.h"
 #include "MeshManager.h"
+#include "AsyncMeshLoader.h"
+#include "AssetHashTable.h"
 #include "SceneNode.h"
 #include "CameraManager.h"
 #include "PrimeEngine/Lua/LuaEnvironment.h"
@@ -35,10 +37,19 @@ PE_IMPLEMENT_CLASS1(MeshInstance, Component);
 MeshInstance::MeshInstance(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself)
 : Component(context, arena, hMyself)
 , m_culledOut(false)
+, m_visibilityMask(0xFFFFFFFF)
+, m_lodLevel(0)
 {
 	
 }
 
+MeshInstance::~MeshInstance()
+{
+	// destroyed while its mesh was still loading
+	if (!m_hAsset.isValid() && AsyncMeshLoader::Instance())
+		AsyncMeshLoader::Instance()->cancelWaiting(this);
+}
+
 void MeshInstance::addDefaultComponents()
 {
 	Component::addDefaultComponents();
@@ -56,6 +67,54 @@ void MeshInstance::initFromFile(const char *assetName, const char *assetPackage,
 	createPhysicsManager(h);
 }
 
+void MeshInstance::initFromFile(const AssetId &id, int &threadOwnershipMask)
+{
+	// for debugging
+	snprintf(m_meshFileName, 127, "%s", id.m_asset);
+
+	Handle h = AssetHashTable::Instance() ? AssetHashTable::Instance()->findOrLoad(id, threadOwnershipMask)
+		: m_pContext->getMeshManager()->getAsset(id.m_asset, id.m_package, threadOwnershipMask);
+
+	initFromRegisteredAsset(h);
+	createPhysicsManager(h);
+}
+
+void MeshInstance::initFromFileAsync(const char *assetName, const char *assetPackage,
+		int &threadOwnershipMask)
+{
+	initFromFileAsync(AssetId(assetName, assetPackage), threadOwnershipMask);
+}
+
+void MeshInstance::initFromFileAsync(const AssetId &id, int &threadOwnershipMask)
+{
+	// for debugging
+	snprintf(m_meshFileName, 127, "%s", id.m_asset);
+
+	Handle hLoaded = AssetHashTable::Instance() ? AssetHashTable::Instance()->find(id) : Handle();
+	if (hLoaded.isValid())
+	{
+		initFromRegisteredAsset(hLoaded);
+		createPhysicsManager(hLoaded);
+		return;
+	}
+
+	if (!AsyncMeshLoader::Instance())
+		AsyncMeshLoader::Construct(*m_pContext, m_arena);
+
+	int requestId = AsyncMeshLoader::Instance()->request(id);
+	if (requestId == -1)
+	{
+		initFromFile(id, threadOwnershipMask);
+		return;
+	}
+
+	// too many instances waiting on this mesh: load it now
+	const bool waiting = AsyncMeshLoader::Instance()->bindWhenReady(requestId, m_hMyself);
+	AsyncMeshLoader::Instance()->release(requestId);
+	if (!waiting)
+		initFromFile(id, threadOwnershipMask);
+}
+
 bool MeshInstance::hasSkinWeights()
 {
 	Mesh *pMesh = m_hAsset.getObject<Mesh>();
@@ -76,9 +135,11 @@ void MeshInstance::createPhysicsManager(PE::Handle &h)
 	PhysicsManager *pPhyManager = new(hPhyManager) PhysicsManager(*m_pContext, m_arena, hPhyManager);
 	pPhyManager->addDefaultComponents();
 
+	// the local box is the mesh's; only the world space data is per instance
 	Mesh *pMesh = h.getObject<Mesh>();
-	PhysicsManager *rhsPhyManager = pMesh->getFirstComponent<PhysicsManager>();
-	*pPhyManager = *rhsPhyManager;
+	PEASSERT(pMesh->m_hCollisionShape.isValid(), "Mesh was not loaded through MeshManager::getAsset");
+	pPhyManager->setShape(pMesh->m_hCollisionShape.getObject<CollisionShape>());
+	pPhyManager->setMeshInstance(this, pMesh);
 
 	// add PhysicsManager 
 	addComponent(hPhyManager);
@@ -13,6 +13,8 @@
 
 // Sibling/Children includes
 #include "Mesh.h"
+#include "FrustumCulling.h"
+#include "AssetHashTable.h"
 
 namespace PE {
 namespace Components {
@@ -27,17 +29,31 @@ struct MeshInstance : public Component
 	void initFromFile(const char *assetName, const char *assetPackage,
 		int &threadOwnershipMask);
 
+	// Same, with the name hashed up front; no string formatting when the mesh is loaded already
+	void initFromFile(const AssetId &id, int &threadOwnershipMask);
+
+	// Same, through AsyncMeshLoader: the instance is bound to its Mesh in a later Event_PRE_RENDER_needsRC
+	// and until then is not drawn. Falls back to initFromFile() when the loader is full
+	void initFromFileAsync(const char *assetName, const char *assetPackage,
+		int &threadOwnershipMask);
+
+	// Same, with the name hashed up front; a mesh that is loaded already is bound right away
+	void initFromFileAsync(const AssetId &id, int &threadOwnershipMask);
+
 	void initFromRegisteredAsset(const PE::Handle &h);
 
 	void createPhysicsManager(PE::Handle &h);
 
-	virtual ~MeshInstance(){}
+	virtual ~MeshInstance();
 
 	virtual void addDefaultComponents();
 
 	bool hasSkinWeights();
 
     bool m_culledOut;
+	PrimitiveTypes::UInt32 m_visibilityMask; // bit per MultiViewCuller view, set by the culling pass
+	CullingState m_cullState;
+	int m_lodLevel; // LOD bucket picked by the culling pass (0 = full detail)
 	Handle m_hAsset;
 
 	int m_skinDebugVertexId;
@@ -8,6 +8,7 @@
 #include "PrimeEngine/FileSystem/FileReader.h"
 #include "PrimeEngine/APIAbstraction/GPUMaterial/GPUMaterialSet.h"
 #include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/PEString.h"
 #include "PrimeEngine/APIAbstraction/Texture/Texture.h"
 #include "PrimeEngine/APIAbstraction/Effect/EffectManager.h"
 #include "PrimeEngine/APIAbstraction/GPUBuffers/VertexBufferGPUManager.h"
@@ -29,6 +30,12 @@
 #include "PrimeEngine/Lua/LuaEnvironment.h"
 
 #include "CharacterControl/PhysicsManager.h"
+#include "SkinJointBounds.h"
+#include "CollisionSidecar.h"
+#include "BinaryMesh.h"
+#include "AsyncMeshLoader.h"
+#include "AssetHashTable.h"
+#include "MeshCpuResidency.h"
 
 namespace PE {
 namespace Components{
@@ -44,15 +51,25 @@ PE::Handle MeshManager::getAsset(const char *asset, const char *package, int &th
 {
 	float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX, maxZ = -FLT_MAX;
 
+	if (!AssetHashTable::Instance())
+		AssetHashTable::Construct(*m_pContext, m_arena);
+
+	// hashed lookup; the string key is only formatted for assets that are loaded now
+	AssetId id(asset, package);
+	Handle h = AssetHashTable::Instance()->find(id);
+	if (h.isValid())
+		return h;
+
 	char key[StrTPair<Handle>::StrSize];
 	sprintf(key, "%s/%s", package, asset);
-	
-	int index = m_assets.findIndex(key);
-	if (index != -1)
+
+	// assets loaded after the hash table filled up are only in m_assets
+	if (AssetHashTable::Instance()->isFull())
 	{
-		return m_assets.m_pairs[index].m_value;
+		int index = m_assets.findIndex(key);
+		if (index != -1)
+			return m_assets.m_pairs[index].m_value;
 	}
-	Handle h;
 
 	if (StringOps::endswith(asset, "skela"))
 	{
@@ -66,8 +83,41 @@ PE::Handle MeshManager::getAsset(const char *asset, const char *package, int &th
 	}
 	else if (StringOps::endswith(asset, "mesha"))
 	{
+		char sourcePath[512];
+		PEString::generatePathname(*m_pContext, asset, package, "Meshes", sourcePath, sizeof(sourcePath));
+
+		// an AsyncMeshLoader request has mapped the file and computed the bounds already
+		MeshLoadStaging *pStaging = AsyncMeshLoader::Instance() ? AsyncMeshLoader::Instance()->findStaging(key) : NULL;
+
+		// prefer the mapped binary form (BinaryMesh::Convert) over parsing text
 		MeshCPU mcpu(*m_pContext, m_arena);
-		mcpu.ReadMesh(asset, package, "");
+		BinaryMesh binaryMesh;
+
+		// source size, time and hash, read at most once per load for the binary and the sidecar
+		BakedSource source;
+		bool haveSource = false;
+		if (pStaging && pStaging->m_haveBinary)
+		{
+			pStaging->m_binaryMesh.fillMeshCPU(*m_pContext, m_arena, mcpu, package);
+		}
+		else if (!pStaging && binaryMesh.open(sourcePath))
+		{
+			binaryMesh.fillMeshCPU(*m_pContext, m_arena, mcpu, package);
+			binaryMesh.close();
+		}
+		else
+		{
+			mcpu.ReadMesh(asset, package, "");
+
+			// missing or stale binary: write it now so the next load maps it
+			char materialSetFile[PE_BINARY_MESH_MAX_NAME];
+			if (BinaryMesh::FindMaterialSetFile(sourcePath, materialSetFile, sizeof(materialSetFile)))
+			{
+				haveSource = MappedFile::GetSourceInfo(sourcePath, source);
+				if (haveSource)
+					BinaryMesh::Write(sourcePath, source, mcpu, materialSetFile);
+			}
+		}
 
 		PE::Handle hMesh("Mesh", sizeof(Mesh));
 		Mesh *pMesh = new(hMesh) Mesh(*m_pContext, m_arena, hMesh);
@@ -85,27 +135,69 @@ PE::Handle MeshManager::getAsset(const char *asset, const char *package, int &th
         // Enable per-mesh culling hook (physics/culling can also be generated in MeshCPU::ReadMesh()).
         pMesh->m_performBoundingVolumeCulling = true; // will now perform tests for this mesh
 
-		// Scan vertex positions to compute min/max for bounding volume baking.
 		PositionBufferCPU *pVB = pMesh->m_hPositionBufferCPU.getObject<PositionBufferCPU>();
-		
-		for (int i = 0; i < pVB->m_values.m_size / 3; ++i)
+
+		// Collision data baked next to the asset on first load; later loads map it instead of scanning vertices.
+		CollisionSidecar sidecar;
+		const bool haveSidecar = sidecar.open(sourcePath);
+
+		if (pStaging && pStaging->m_haveBounds)
+		{
+			minX = pStaging->m_min[0]; minY = pStaging->m_min[1]; minZ = pStaging->m_min[2];
+			maxX = pStaging->m_max[0]; maxY = pStaging->m_max[1]; maxZ = pStaging->m_max[2];
+		}
+		else if (haveSidecar)
+		{
+			const CollisionSidecarHeader &header = sidecar.getHeader();
+			minX = header.m_localMin[0]; minY = header.m_localMin[1]; minZ = header.m_localMin[2];
+			maxX = header.m_localMax[0]; maxY = header.m_localMax[1]; maxZ = header.m_localMax[2];
+		}
+		else
+		{
+			// Scan vertex positions to compute min/max for bounding volume baking.
+			for (int i = 0; i < pVB->m_values.m_size / 3; ++i)
+			{
+				float x = pVB->m_values[i * 3];
+				float y = pVB->m_values[i * 3 + 1];
+				float z = pVB->m_values[i * 3 + 2];
+
+				PhysicsManager::setExtremeValue(x, y, z, minX, maxX, minY, maxY, minZ, maxZ);
+			}
+		}
+
+		// Skinned meshes also keep per joint bind pose boxes for cheap animated bounds.
+		if (pMesh->m_hSkinWeightsCPU.isValid())
+		{
+			PE::Handle hSkinBounds("SkinJointBounds", sizeof(SkinJointBounds));
+			SkinJointBounds *pSkinBounds = new(hSkinBounds) SkinJointBounds(*m_pContext, m_arena);
+			if (haveSidecar && sidecar.getHeader().m_numJoints)
+				pSkinBounds->initFromBoxes(sidecar.getJointBoxes(), sidecar.getHeader().m_numJoints);
+			else
+				pSkinBounds->build(pVB, pMesh->m_hSkinWeightsCPU.getObject<SkinWeightsCPU>());
+			pMesh->m_hSkinJointBounds = hSkinBounds;
+
+			// the streams for CPU skinning are built on first use, see CpuSkinning::AcquireStreams()
+		}
+
+		if (!haveSidecar)
 		{
-			float x = pVB->m_values[i * 3];
-			float y = pVB->m_values[i * 3 + 1];
-			float z = pVB->m_values[i * 3 + 2];
-			
-			PhysicsManager::setExtremeValue(x, y, z, minX, maxX, minY, maxY, minZ, maxZ);
+			if (!haveSource)
+				haveSource = MappedFile::GetSourceInfo(sourcePath, source);
+			if (haveSource)
+			{
+				CollisionSidecar::Bake(sourcePath, source, pVB->m_values.getFirstPtr(), pVB->m_values.m_size / 3,
+					pMesh->m_hSkinJointBounds.isValid() ? pMesh->m_hSkinJointBounds.getObject<SkinJointBounds>() : NULL);
+			}
 		}
+		sidecar.close();
 
-		// Create PhysicsManager and pre-bake bounds from computed min/max.
-		PE::Handle hPhyManager("PhysicsManager", sizeof(PhysicsManager));
-		PhysicsManager *pPhyManager = new(hPhyManager) PhysicsManager(*m_pContext, m_arena, hPhyManager);
-		pPhyManager->addDefaultComponents();
-		
-		// Construct the bounding box from extrema.
-		pPhyManager->buildBoundingVolume(minX, maxX, minY, maxY, minZ, maxZ);
+		// One local box for the mesh; instance PhysicsManagers reference it.
+		PE::Handle hShape("CollisionShape", sizeof(CollisionShape));
+		new(hShape) CollisionShape(minX, maxX, minY, maxY, minZ, maxZ);
+		pMesh->m_hCollisionShape = hShape;
 
-		pMesh->addComponent(hPhyManager);
+		// uploaded and baked; the vertex buffers go unless the asset is flagged to keep them
+		MeshCpuResidency::ApplyAfterLoad(*m_pContext, m_arena, pMesh, sourcePath, id);
 
 		h = hMesh;
 	}
@@ -115,6 +207,7 @@ PE::Handle MeshManager::getAsset(const char *asset, const char *package, int &th
 
 	RootSceneNode::Instance()->addComponent(h);
 	m_assets.add(key, h);
+	AssetHashTable::Instance()->add(id, h);
 	return h;
 }
 
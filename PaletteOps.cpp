@@ -0,0 +1,261 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <string.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "PaletteOps.h"
+
+// the SSE switch is defined by the header above
+#if PE_PALETTE_OPS_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+int g_validateFastPalette = 0;
+
+namespace PE {
+namespace Components {
+
+// scalar versions of the affine (first three rows, 12 floats) ops, used where SSE is not available
+static inline void scaleAffineScalar(const PrimitiveTypes::Float32 *pSrc, PrimitiveTypes::Float32 scale, PrimitiveTypes::Float32 *pDst)
+{
+	for (int k = 0; k < 12; ++k)
+		pDst[k] = pSrc[k] * scale;
+}
+
+static inline void lerpAffineScalar(const PrimitiveTypes::Float32 *a, const PrimitiveTypes::Float32 *b, PrimitiveTypes::Float32 t,
+	PrimitiveTypes::Float32 *pDst)
+{
+	for (int k = 0; k < 12; ++k)
+		pDst[k] = a[k] + (b[k] - a[k]) * t;
+}
+
+// Matrix4x4 versions of the ops, as the palette code did them before PaletteOps; the reference for the checks
+static void scaleReference(const Matrix4x4 &src, PrimitiveTypes::Float32 scale, Matrix4x4 &dst)
+{
+	Matrix4x4 scaleMatrix;
+	scaleMatrix.importScale(scale, scale, scale);
+	dst = scaleMatrix * src;
+}
+
+static void lerpReference(const Matrix4x4 &from, const Matrix4x4 &to, PrimitiveTypes::Float32 t, Matrix4x4 &dst)
+{
+	for (int r = 0; r < 4; ++r)
+		for (int c = 0; c < 4; ++c)
+			dst.m[r][c] = from.m[r][c] + (to.m[r][c] - from.m[r][c]) * t;
+}
+
+// tolerance relative to the largest element of the reference
+static PrimitiveTypes::Float32 referenceTolerance(const Matrix4x4 &reference)
+{
+	PrimitiveTypes::Float32 maxAbs = 0.0f;
+	for (int r = 0; r < 3; ++r)
+		for (int c = 0; c < 4; ++c)
+			if (fabsf(reference.m[r][c]) > maxAbs)
+				maxAbs = fabsf(reference.m[r][c]);
+	return 1e-5f * (1.0f + maxAbs);
+}
+
+#if PE_PALETTE_OPS_USE_SSE
+static void checkAgainstReference(const Matrix4x4 &fast, const Matrix4x4 &reference, int joint)
+{
+	if (PaletteOps::maxDifference(&fast, &reference, 1) > referenceTolerance(reference))
+	{
+		PEINFO("PaletteOps: SSE result of joint %d differs from the Matrix4x4 path\n", joint);
+		PEASSERT(false, "SSE palette op does not match the Matrix4x4 path");
+	}
+}
+#endif
+
+void PaletteOps::applyUniformScale(Matrix4x4 *pPalette, int numJoints, PrimitiveTypes::Float32 scale)
+{
+#if PE_PALETTE_OPS_USE_SSE
+	const __m128 s = _mm_set1_ps(scale);
+	const bool validate = g_validateFastPalette != 0;
+	for (int j = 0; j < numJoints; ++j)
+	{
+		PrimitiveTypes::Float32 *p = &pPalette[j].m[0][0];
+		Matrix4x4 reference;
+		if (validate)
+			scaleReference(pPalette[j], scale, reference);
+
+		_mm_storeu_ps(p + 0, _mm_mul_ps(_mm_loadu_ps(p + 0), s));
+		_mm_storeu_ps(p + 4, _mm_mul_ps(_mm_loadu_ps(p + 4), s));
+		_mm_storeu_ps(p + 8, _mm_mul_ps(_mm_loadu_ps(p + 8), s));
+
+		if (validate)
+			checkAgainstReference(pPalette[j], reference, j);
+	}
+#else
+	for (int j = 0; j < numJoints; ++j)
+	{
+		PrimitiveTypes::Float32 *p = &pPalette[j].m[0][0];
+		scaleAffineScalar(p, scale, p);
+	}
+#endif
+}
+
+// source joint as a Matrix4x4, for the reference blend
+static void sourceMatrix(const PrimitiveTypes::Float32 *pSrc, int srcStride, Matrix4x4 &dst)
+{
+	if (srcStride == 16)
+		memcpy(dst.m, pSrc, sizeof(dst.m));
+	else
+		((const AffineMatrix3x4 *)(pSrc))->toMatrix4x4(dst);
+}
+
+// blends the 12 affine floats of each joint; source strides are 16 (Matrix4x4) or 12 (AffineMatrix3x4) floats
+static void lerpAffine(const PrimitiveTypes::Float32 *pFrom, const PrimitiveTypes::Float32 *pTo, int srcStride,
+	PrimitiveTypes::Float32 t, Matrix4x4 *pOut, int numJoints)
+{
+#if PE_PALETTE_OPS_USE_SSE
+	const __m128 vt = _mm_set1_ps(t);
+	const bool validate = g_validateFastPalette != 0;
+#endif
+	for (int j = 0; j < numJoints; ++j)
+	{
+		const PrimitiveTypes::Float32 *a = pFrom + j * srcStride;
+		const PrimitiveTypes::Float32 *b = pTo + j * srcStride;
+		PrimitiveTypes::Float32 *o = &pOut[j].m[0][0];
+#if PE_PALETTE_OPS_USE_SSE
+		Matrix4x4 reference;
+		if (validate)
+		{
+			Matrix4x4 from, to;
+			sourceMatrix(a, srcStride, from);
+			sourceMatrix(b, srcStride, to);
+			lerpReference(from, to, t, reference);
+		}
+
+		for (int k = 0; k < 12; k += 4)
+		{
+			const __m128 va = _mm_loadu_ps(a + k);
+			_mm_storeu_ps(o + k, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + k), va), vt)));
+		}
+
+		if (validate)
+			checkAgainstReference(pOut[j], reference, j);
+#else
+		lerpAffineScalar(a, b, t, o);
+#endif
+		pOut[j].m[3][0] = pOut[j].m[3][1] = pOut[j].m[3][2] = 0.0f;
+		pOut[j].m[3][3] = 1.0f;
+	}
+}
+
+void PaletteOps::lerp(const Matrix4x4 *pFrom, const Matrix4x4 *pTo, PrimitiveTypes::Float32 t, Matrix4x4 *pOut, int numJoints)
+{
+	lerpAffine(&pFrom[0].m[0][0], &pTo[0].m[0][0], 16, t, pOut, numJoints);
+}
+
+void PaletteOps::lerp(const AffineMatrix3x4 *pFrom, const AffineMatrix3x4 *pTo, PrimitiveTypes::Float32 t, Matrix4x4 *pOut, int numJoints)
+{
+	lerpAffine(&pFrom[0].m[0][0], &pTo[0].m[0][0], 12, t, pOut, numJoints);
+}
+
+void PaletteOps::pack(const Matrix4x4 *pSrc, AffineMatrix3x4 *pDst, int numJoints)
+{
+	for (int j = 0; j < numJoints; ++j)
+	{
+		const PrimitiveTypes::Float32 *s = &pSrc[j].m[0][0];
+		PrimitiveTypes::Float32 *d = &pDst[j].m[0][0];
+#if PE_PALETTE_OPS_USE_SSE
+		_mm_storeu_ps(d + 0, _mm_loadu_ps(s + 0));
+		_mm_storeu_ps(d + 4, _mm_loadu_ps(s + 4));
+		_mm_storeu_ps(d + 8, _mm_loadu_ps(s + 8));
+#else
+		memcpy(d, s, sizeof(AffineMatrix3x4));
+#endif
+	}
+}
+
+void PaletteOps::unpack(const AffineMatrix3x4 *pSrc, Matrix4x4 *pDst, int numJoints)
+{
+	for (int j = 0; j < numJoints; ++j)
+		pSrc[j].toMatrix4x4(pDst[j]);
+}
+
+PrimitiveTypes::Float32 PaletteOps::maxDifference(const Matrix4x4 *pA, const Matrix4x4 *pB, int numJoints)
+{
+	PrimitiveTypes::Float32 maxDiff = 0.0f;
+	for (int j = 0; j < numJoints; ++j)
+		for (int r = 0; r < 3; ++r)
+			for (int c = 0; c < 4; ++c)
+			{
+				const PrimitiveTypes::Float32 d = fabsf(pA[j].m[r][c] - pB[j].m[r][c]);
+				if (d > maxDiff)
+					maxDiff = d;
+			}
+	return maxDiff;
+}
+
+// compares numJoints results with the reference and logs every joint over tolerance
+static bool checkPalette(const char *op, const Matrix4x4 *pResult, const Matrix4x4 *pReference, int numJoints)
+{
+	bool ok = true;
+	for (int j = 0; j < numJoints; ++j)
+	{
+		const PrimitiveTypes::Float32 diff = PaletteOps::maxDifference(&pResult[j], &pReference[j], 1);
+		if (diff > referenceTolerance(pReference[j]))
+		{
+			PEINFO("PaletteOps::selfCheck: %s differs from the Matrix4x4 path by %f at joint %d\n", op, diff, j);
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+bool PaletteOps::selfCheck()
+{
+	// odd joint count and translations much larger than the rotation part, like real palettes
+	static const int NumJoints = 7;
+	Matrix4x4 from[NumJoints], to[NumJoints], result[NumJoints], reference[NumJoints];
+	for (int j = 0; j < NumJoints; ++j)
+	{
+		for (int r = 0; r < 4; ++r)
+			for (int c = 0; c < 4; ++c)
+			{
+				const PrimitiveTypes::Float32 k = (PrimitiveTypes::Float32)(j * 16 + r * 4 + c);
+				from[j].m[r][c] = r == 3 ? (c == 3 ? 1.0f : 0.0f) : sinf(k) * (c == 3 ? 50.0f : 1.0f);
+				to[j].m[r][c] = r == 3 ? (c == 3 ? 1.0f : 0.0f) : cosf(k * 0.7f) * (c == 3 ? 50.0f : 1.0f);
+			}
+	}
+
+	bool ok = true;
+
+	const PrimitiveTypes::Float32 scale = 1.37f;
+	for (int j = 0; j < NumJoints; ++j)
+	{
+		result[j] = from[j];
+		scaleReference(from[j], scale, reference[j]);
+	}
+	applyUniformScale(result, NumJoints, scale);
+	ok &= checkPalette("applyUniformScale", result, reference, NumJoints);
+
+	const PrimitiveTypes::Float32 t = 0.3f;
+	for (int j = 0; j < NumJoints; ++j)
+		lerpReference(from[j], to[j], t, reference[j]);
+	lerp(from, to, t, result, NumJoints);
+	ok &= checkPalette("lerp", result, reference, NumJoints);
+
+	AffineMatrix3x4 packedFrom[NumJoints], packedTo[NumJoints];
+	pack(from, packedFrom, NumJoints);
+	pack(to, packedTo, NumJoints);
+	lerp(packedFrom, packedTo, t, result, NumJoints);
+	ok &= checkPalette("lerp of packed palettes", result, reference, NumJoints);
+
+	unpack(packedFrom, result, NumJoints);
+	ok &= checkPalette("pack/unpack", result, from, NumJoints);
+
+	if (ok)
+		PEINFO("PaletteOps::selfCheck: all ops match the Matrix4x4 path\n");
+	return ok;
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,55 @@
+#ifndef __PYENGINE_2_0_PALETTE_OPS_H__
+#define __PYENGINE_2_0_PALETTE_OPS_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+
+// Sibling/Children includes
+#include "PoseBounds.h" // PE_POSE_BOUNDS_USE_SSE
+#include "AffineMatrix3x4.h"
+
+#define PE_PALETTE_OPS_USE_SSE PE_POSE_BOUNDS_USE_SSE
+
+// when set, every joint written by an SSE palette op is checked against the Matrix4x4 path (debug builds),
+// and AnimationSystem runs PaletteOps::selfCheck() once
+extern int g_validateFastPalette;
+
+namespace PE {
+namespace Components {
+
+// Whole-palette operations on joint matrices, 4 floats per instruction where SSE is available.
+// Joint matrices are affine (last row 0 0 0 1), so only the first three rows are touched.
+struct PaletteOps
+{
+	// palette[i] = uniformScale * palette[i], i.e. the skin scale applied to rotation and translation
+	static void applyUniformScale(Matrix4x4 *pPalette, int numJoints, PrimitiveTypes::Float32 scale);
+
+	// out[i] = from[i] + (to[i] - from[i]) * t
+	static void lerp(const Matrix4x4 *pFrom, const Matrix4x4 *pTo, PrimitiveTypes::Float32 t, Matrix4x4 *pOut, int numJoints);
+
+	// same blend of packed palettes, written out as full matrices
+	static void lerp(const AffineMatrix3x4 *pFrom, const AffineMatrix3x4 *pTo, PrimitiveTypes::Float32 t, Matrix4x4 *pOut, int numJoints);
+
+	// Matrix4x4 <-> 3x4 affine conversion of whole palettes
+	static void pack(const Matrix4x4 *pSrc, AffineMatrix3x4 *pDst, int numJoints);
+	static void unpack(const AffineMatrix3x4 *pSrc, Matrix4x4 *pDst, int numJoints);
+
+	// largest element difference of the first three rows
+	static PrimitiveTypes::Float32 maxDifference(const Matrix4x4 *pA, const Matrix4x4 *pB, int numJoints);
+
+	// Runs every op on fixed palettes and compares with the Matrix4x4 path (scale matrix multiply,
+	// element-wise 4x4 blend). Returns false and logs the op on a mismatch
+	static bool selfCheck();
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
@@ -2,58 +2,94 @@
 
 #include "PrimeEngine/Lua/LuaEnvironment.h"
 #include "PrimeEngine/Scene/MeshInstance.h"
-#include "PrimeEngine/Scene/RootSceneNode.h"
+#include "PrimeEngine/Scene/FrameArena.h"
 
 namespace PE {
 namespace Components {
 
 PE_IMPLEMENT_CLASS1(PhysicsManager, Component);
 
+SlabPool<CollisionShape> PhysicsManager::s_shapePool;
+int PhysicsManager::s_numDroppedTotal = 0;
+
 // Constructor -------------------------------------------------------------
 PhysicsManager::PhysicsManager(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself) 
 	: Component(context, arena, hMyself)
-	, m_boundingBoxPlanes(context, arena, 6, Plane())
-	, m_collisionMeshInstance(context, arena, 1)
-	, m_collisionSkipList(context, arena, 1)
-	, m_collisionPlane(context, arena, 1)
-	, m_velocity(0)
-	, m_acceleration(0)
-	, m_gravity(0)
-	, m_mess(0)
-	, m_fallingTime(0)
-	, m_accelerationOfGravity(0.8)
+	, m_body(PhysicsWorld::Instance().addBody(this))
+	, m_controller(-1)
+	, m_pMeshInstance(NULL)
+	, m_pMesh(NULL)
 	, m_collisionCheck(0)
 	, m_collisionCount(0)
-	, m_backward(0)
 	, m_stuckCheck(0)
+	, m_pShape(NULL)
+	, m_pOwnedShape(NULL)
+	, m_numDroppedContacts(0)
+	, m_numDroppedPlanes(0)
 {
 	buildCollisionSkipList();
 
-	Matrix4x4 m;
 	Vector3 v;
-
-	for (int i = 0; i < 4; ++i) {
-		m_boundingBox.add(m);
-		m_boundingBoxAfterTransform.add(m);
-	}
-	for (int i = 0; i < 8; ++i) {
-		m_boundingBoxVertex.add(v);
+	for (int i = 0; i < 8; ++i)
 		m_boundingBoxVertexAfterTransform.add(v);
+
+	for (int i = 0; i < 6; ++i)
+		m_boundingBoxPlanes.add(Plane());
+}
+
+PhysicsManager::~PhysicsManager()
+{
+	s_shapePool.destroy(m_pOwnedShape);
+
+	PhysicsWorld &world = PhysicsWorld::Instance();
+	if (m_controller != -1)
+		world.removeController(m_controller);
+	world.removeBody(m_body);
+}
+
+CharacterControllerState &PhysicsManager::getController()
+{
+	PhysicsWorld &world = PhysicsWorld::Instance();
+	if (m_controller == -1)
+		m_controller = world.addController();
+	return world.getController(m_controller);
+}
+
+// Broadphase candidate buffer: one per thread and frame, taken from the frame arena by the first
+// collisionDetectionAll() of the frame and reused by the rest
+static int *frameCandidateBuffer(int numBodies)
+{
+	static thread_local int *s_pCandidates = NULL;
+	static thread_local int s_capacity = 0;
+	static thread_local PrimitiveTypes::UInt32 s_frameIndex = 0;
+
+	if (!s_pCandidates || s_frameIndex != FrameArena::FrameIndex() || s_capacity < numBodies)
+	{
+		s_pCandidates = (int *)(FrameArena::Current()->allocate(sizeof(int) * numBodies));
+		s_capacity = numBodies;
+		s_frameIndex = FrameArena::FrameIndex();
 	}
+	return s_pCandidates;
 }
 
 bool PhysicsManager::collisionDetectionAll()
 {
 	m_stuckCheck = false;
 	m_collisionCount = 0;
-	m_collisionMeshInstance.clear();
-	m_collisionPlane.clear();
+	m_collisionMeshInstance.m_size = 0;
+	m_collisionPlane.m_size = 0;
+	m_numDroppedContacts = 0;
+	m_numDroppedPlanes = 0;
 
-	RootSceneNode *rSN = RootSceneNode::Instance();
+	// broadphase: world boxes of scene geometry overlapping ours, into this frame's candidate buffer
+	PhysicsWorld &world = PhysicsWorld::Instance();
+	int *pCandidates = frameCandidateBuffer(world.getNumBodies());
+	const int numCandidates = world.queryOverlaps(m_body, PE_PHYSICS_BODY_MESH_INSTANCE, pCandidates, world.getNumBodies());
 
-	for (int i = rSN->getFirstComponentIndex<Mesh>(); i != -1; i = rSN->getFirstComponentIndex<Mesh>(i + 1))
+	for (int c = 0; c < numCandidates; ++c)
 	{
-		Mesh *pMesh = rSN->getComponentByIndex<Mesh>(i);
+		PhysicsManager *pPM = world.getBody(pCandidates[c]);
+		Mesh *pMesh = pPM->m_pMesh;
 		if (!pMesh->isEnabled()) continue;
 
 		bool checkSkipMesh = false;
@@ -67,29 +103,34 @@ bool PhysicsManager::collisionDetectionAll()
 		}
 		if (checkSkipMesh) continue;
 
-		for (PrimitiveTypes::Int32 j = 0; j < pMesh->m_instances.m_size; ++j)
+		// narrowphase
+		if (checkCollisionPhysicsManager(pPM))
 		{
-			MeshInstance *pInst = pMesh->m_instances[j].getObject<MeshInstance>();
-			PhysicsManager *pPM = pInst->getFirstComponent<PhysicsManager>();
-			
-			// Run the narrow-phase test against each MeshInstance we encounter
-			if (pPM && checkCollisionPhysicsManager(pPM))
+			++m_collisionCount;
+
+			if (checkStuck(pPM))
+				m_stuckCheck = true;
+
+			if (StringOps::startsswith(pMesh->m_meshFileName, "cobbleplane.x_pplaneshape1_mesh"))
 			{
-				++m_collisionCount;
-
-				if (checkStuck(pPM))
-					m_stuckCheck = true;
-
-				if (StringOps::startsswith(pMesh->m_meshFileName, "cobbleplane.x_pplaneshape1_mesh"))
-				{
-					m_curStandPlane = pPM->m_boundingBoxPlanes[0];
-					continue;
-				}
-				addCollisionPlane(pPM);
-				m_collisionMeshInstance.add(pInst);
+				m_curStandPlane = pPM->m_boundingBoxPlanes[0];
+				continue;
 			}
+			addCollisionPlane(pPM);
+			if (m_collisionMeshInstance.m_size < PE_PHYSICS_MAX_CONTACTS)
+				m_collisionMeshInstance.add(pPM->m_pMeshInstance);
+			else
+				++m_numDroppedContacts;
 		}
 	}
+
+	if (m_numDroppedContacts || m_numDroppedPlanes)
+	{
+		// once, so a crowded scene is noticed without flooding the log
+		if (s_numDroppedTotal == 0)
+			PEINFO("PhysicsManager: contact lists full, dropped %d contacts and %d planes (PE_PHYSICS_MAX_CONTACTS)\n", m_numDroppedContacts, m_numDroppedPlanes);
+		s_numDroppedTotal += m_numDroppedContacts + m_numDroppedPlanes;
+	}
 	
 	m_collisionCheck = (m_collisionCount > 0);
 	if (m_collisionCount <= 1) m_stuckCheck = false;
@@ -150,22 +191,40 @@ void PhysicsManager::addCollisionPlane(PhysicsManager *pPM)
 	{
 		// Compare each plane with its opposite face (i vs i+3: e.g., bottom/top).
 		// If exactly one of the pair intersects, record that specific plane.
-		if (checkPlane[i] ^ checkPlane[i + 3])
+		if (!(checkPlane[i] ^ checkPlane[i + 3]))
+			continue;
+
+		if (m_collisionPlane.m_size < PE_PHYSICS_MAX_CONTACT_PLANES)
 		{
 			checkPlane[i] ? m_collisionPlane.add(pPM->m_boundingBoxPlanes[i]) :
 			                m_collisionPlane.add(pPM->m_boundingBoxPlanes[i + 3]);
 		}
+		else
+		{
+			++m_numDroppedPlanes;
+		}
+	}
+}
+
+bool PhysicsManager::hasCollisionPlane(Plane &p)
+{
+	for (int i = 0; i < m_collisionPlane.m_size; ++i)
+	{
+		if (m_collisionPlane[i] == p)
+			return true;
 	}
+	return false;
 }
 
 bool PhysicsManager::checkCollisionPlane(Plane &p)
 {
+	const Vector3 center = getBoundingBoxCenter();
 	for (int i = 0; i < 8; ++i) {
-		Vector3 extent = m_boundingBoxVertexAfterTransform[i] - m_boundingBoxCenter;
+		Vector3 extent = m_boundingBoxVertexAfterTransform[i] - center;
 
 		// Project half-extent onto plane normal, compare against center-to-plane distance
 		float d_projection = abs(p.getN().dotProduct(extent));  // projected half-width along plane normal
-		float d_centerToP = abs(m_boundingBoxCenter.dotProduct(p.getN()) + p.getD());
+		float d_centerToP = abs(center.dotProduct(p.getN()) + p.getD());
 
 		// A hit occurs if the center-to-plane distance is within the projected half-extent
 		if ((d_centerToP <= d_projection) && (p != Plane())) return true;
@@ -175,11 +234,12 @@ bool PhysicsManager::checkCollisionPlane(Plane &p)
 
 bool PhysicsManager::checkStuck(PhysicsManager *pPM)
 {
+	const Vector3 center = getBoundingBoxCenter();
 	int insideCounter = 0;
 	for (int i = 0; i < pPM->m_boundingBoxPlanes.m_size; ++i)
 	{
 		Plane plane = pPM->m_boundingBoxPlanes[i];
-		if (plane.isInsidePlane(m_boundingBoxCenter))
+		if (plane.isInsidePlane(center))
 		{
 			++insideCounter;
 		}
@@ -189,48 +249,31 @@ bool PhysicsManager::checkStuck(PhysicsManager *pPM)
 	return insideCounter == 6;
 }
 
+void PhysicsManager::setShape(const CollisionShape *pShape)
+{
+	m_pShape = pShape;
+}
+
+void PhysicsManager::setMeshInstance(MeshInstance *pInst, Mesh *pMesh)
+{
+	m_pMeshInstance = pInst;
+	m_pMesh = pMesh;
+	PhysicsWorld::Instance().setFlags(m_body, PE_PHYSICS_BODY_MESH_INSTANCE);
+}
+
 void PhysicsManager::buildBoundingVolume(float minX, float maxX, float minY, float maxY, float minZ, float maxZ)
 {
-	m_boundingBox[0].setPos(Vector3(minX, minY, minZ));
-	m_boundingBox[0].setU(Vector3(maxX - minX, 0, 0));
-	m_boundingBox[0].setV(Vector3(0, maxY - minY, 0));
-	m_boundingBox[0].setN(Vector3(0, 0, maxZ - minZ));
-
-	m_boundingBox[1].setPos(Vector3(maxX, minY, maxZ));
-	m_boundingBox[1].setU(Vector3(minX - maxX, 0, 0));
-	m_boundingBox[1].setV(Vector3(0, maxY - minY, 0));
-	m_boundingBox[1].setN(Vector3(0, 0, minZ - maxZ));
-
-	m_boundingBox[2].setPos(Vector3(maxX, maxY, minZ));
-	m_boundingBox[2].setU(Vector3(minX - maxX, 0, 0));
-	m_boundingBox[2].setV(Vector3(0, minY - maxY, 0));
-	m_boundingBox[2].setN(Vector3(0, 0, maxZ - minZ));
-
-	m_boundingBox[3].setPos(Vector3(minX, maxY, maxZ));
-	m_boundingBox[3].setU(Vector3(maxX - minX, 0, 0));
-	m_boundingBox[3].setV(Vector3(0, minY - maxY, 0));
-	m_boundingBox[3].setN(Vector3(0, 0, minZ - maxZ));
-
-	// Assemble the 8 local-space corners of the box
-	// lower ring
-	m_boundingBoxVertex[0] = Vector3(minX, minY, minZ);
-	m_boundingBoxVertex[1] = Vector3(minX, minY, maxZ);
-	m_boundingBoxVertex[2] = Vector3(maxX, minY, minZ);
-	m_boundingBoxVertex[3] = Vector3(maxX, minY, maxZ);
-
-	// upper ring
-	m_boundingBoxVertex[4] = Vector3(minX, maxY, minZ);
-	m_boundingBoxVertex[5] = Vector3(minX, maxY, maxZ);
-	m_boundingBoxVertex[6] = Vector3(maxX, maxY, minZ);
-	m_boundingBoxVertex[7] = Vector3(maxX, maxY, maxZ);
+	if (!m_pOwnedShape)
+		m_pOwnedShape = new(s_shapePool.allocate()) CollisionShape(minX, maxX, minY, maxY, minZ, maxZ);
+	else
+		m_pOwnedShape->build(minX, maxX, minY, maxY, minZ, maxZ);
+	m_pShape = m_pOwnedShape;
 }
 
 void PhysicsManager::buildBoundingVolumeAfterTransform(const Matrix4x4 &worldMatrix)
 {
-	for (int i = 0; i < 4; ++i)
-		m_boundingBoxAfterTransform[i] = worldMatrix * m_boundingBox[i];
 	for (int i = 0; i < 8; ++i)
-		m_boundingBoxVertexAfterTransform[i] = worldMatrix * m_boundingBoxVertex[i];
+		m_boundingBoxVertexAfterTransform[i] = worldMatrix * m_pShape->m_vertices[i];
 	
 	m_normalVector = m_boundingBoxVertexAfterTransform[4] - m_boundingBoxVertexAfterTransform[0];
 
@@ -249,12 +292,12 @@ void PhysicsManager::buildBoundingVolumeAfterTransform(const Matrix4x4 &worldMat
 void PhysicsManager::setBoundingBoxCenterAndHalfLength()
 {
 	// Center is the midpoint of the main diagonal (min->max corner)
-	m_boundingBoxCenter = (m_boundingBoxVertexAfterTransform[0] + m_boundingBoxVertexAfterTransform[7]) / 2.0f;
+	Vector3 center = (m_boundingBoxVertexAfterTransform[0] + m_boundingBoxVertexAfterTransform[7]) / 2.0f;
 
 	float lengthX = abs(m_boundingBoxVertexAfterTransform[2].getX() - m_boundingBoxVertexAfterTransform[0].getX());
 	float lengthY = abs(m_boundingBoxVertexAfterTransform[4].getY() - m_boundingBoxVertexAfterTransform[0].getY());
 	float lengthZ = abs(m_boundingBoxVertexAfterTransform[1].getZ() - m_boundingBoxVertexAfterTransform[0].getZ());
-	m_boundingBoxHalfLength = Vector3(lengthX * 0.5f, lengthY * 0.5f, lengthZ * 0.5f);
+	PhysicsWorld::Instance().setCenterAndHalfLength(m_body, center, Vector3(lengthX * 0.5f, lengthY * 0.5f, lengthZ * 0.5f));
 }
 
 void PhysicsManager::setExtremeAxisPos()
@@ -267,9 +310,7 @@ void PhysicsManager::setExtremeAxisPos()
 		setExtremeValue(v.getX(), v.getY(), v.getZ(), minX, maxX, minY, maxY, minZ, maxZ);
 	}
 
-	m_minX = minX; m_maxX = maxX;
-	m_minY = minY; m_maxY = maxY;
-	m_minZ = minZ; m_maxZ = maxZ;
+	PhysicsWorld::Instance().setBounds(m_body, minX, maxX, minY, maxY, minZ, maxZ);
 }
 
 void PhysicsManager::setExtremeValue(const float &x, const float &y, const float &z, float &minX, float &maxX,
@@ -285,11 +326,14 @@ void PhysicsManager::setExtremeValue(const float &x, const float &y, const float
 
 void PhysicsManager::operator=(const PhysicsManager &rhs)
 {
-	this->m_velocity = rhs.m_velocity;
-	this->m_gravity = rhs.m_gravity;
-	this->m_boundingBox = rhs.m_boundingBox;
-	this->m_boundingBoxAfterTransform = rhs.m_boundingBoxAfterTransform; 
-	this->m_boundingBoxVertex = rhs.m_boundingBoxVertex;
+	if (rhs.m_controller != -1)
+	{
+		CharacterControllerState &controller = getController();
+		const CharacterControllerState &rhsController = PhysicsWorld::Instance().getController(rhs.m_controller);
+		controller.m_velocity = rhsController.m_velocity;
+		controller.m_gravity = rhsController.m_gravity;
+	}
+	this->m_pShape = rhs.m_pShape; // shared, not copied
 	this->m_boundingBoxVertexAfterTransform = rhs.m_boundingBoxVertexAfterTransform;
 }
 
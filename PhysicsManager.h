@@ -8,9 +8,18 @@
 #include "PrimeEngine/Scene/MeshInstance.h"
 #include "PrimeEngine/Math/Plane.h"
 #include "Events/Events.h"
+#include "CollisionShape.h"
+#include "SlabPool.h"
+#include "PhysicsWorld.h"
 
 //#define USE_DRAW_COMPONENT
 
+// inline capacities of the per-body contact lists, refilled every collisionDetectionAll().
+// Contacts past them are dropped and counted in m_numDroppedContacts / m_numDroppedPlanes
+#define PE_PHYSICS_MAX_CONTACTS 16
+#define PE_PHYSICS_MAX_CONTACT_PLANES (PE_PHYSICS_MAX_CONTACTS * 3) // up to 3 faces per contact
+#define PE_PHYSICS_MAX_SKIP_PREFIXES 4
+
 namespace PE {
 namespace Components {
 
@@ -21,6 +30,8 @@ struct PhysicsManager : public Component
 	// Constructor -------------------------------------------------------------
 	PhysicsManager(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself);
 
+	virtual ~PhysicsManager();
+
 	// avoid inline body in header
 	PhysicsManager getInstance();
 
@@ -29,6 +40,10 @@ struct PhysicsManager : public Component
 
 	// Build / setup ---------------------------------------------------------
 	void buildCollisionSkipList();
+	void setShape(const CollisionShape *pShape); // shared, e.g. the Mesh's; not owned
+	// makes this body scene geometry that collisionDetectionAll() of other bodies tests against
+	void setMeshInstance(MeshInstance *pInst, Mesh *pMesh);
+	// own shape for bodies whose bounds change (skeletons); allocated on first use
 	void buildBoundingVolume(float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
 	void buildBoundingVolumeAfterTransform(const Matrix4x4 &worldMatrix);
 	void setBoundingBoxCenterAndHalfLength();
@@ -43,42 +58,40 @@ struct PhysicsManager : public Component
 	bool checkStuck(PhysicsManager *pPM);
 	bool checkSegmentIntersect(float lminP, float lmaxP, float rminP, float rmaxP);
 	void addCollisionPlane(PhysicsManager *pPM);
+	bool hasCollisionPlane(Plane &p);                // p is in m_collisionPlane
 
 	void operator=(const PhysicsManager &rhs);
 
+	// Body data in PhysicsWorld ------------------------------------------------
+	Vector3 getBoundingBoxCenter() const { return PhysicsWorld::Instance().getCenter(m_body); }
+	Vector3 getBoundingBoxHalfLength() const { return PhysicsWorld::Instance().getHalfLength(m_body); }
+	// movement state, allocated on first use so scene geometry has none
+	CharacterControllerState &getController();
+
 	// Data -------------------------------------------------------------------
-	float m_minX;
-	float m_maxX;
-	float m_minY;
-	float m_maxY;
-	float m_minZ;
-	float m_maxZ;
-	float m_velocity;
-	float m_mess;
-	float m_acceleration;
-	float m_accelerationOfGravity;
-	float m_gravity;
-	float m_fallingTime;
+	int m_body;       // index in PhysicsWorld
+	int m_controller; // index of the CharacterControllerState in PhysicsWorld, -1 until getController()
+	MeshInstance *m_pMeshInstance; // set for scene geometry
+	Mesh *m_pMesh;
 	bool m_collisionCheck;
 	int m_collisionCount;
-	bool m_backward;
 	bool m_stuckCheck;
 	Vector3 m_normalVector;  // normal vector
-	Vector3 m_moveAfterBackWard;
-	Vector3 m_moveBackWard;
-	Vector3 m_moveDodge;
-	Plane m_curCollisionPlane;
 	Plane m_curStandPlane;
-	PEStaticVector<Matrix4x4, 4> m_boundingBox;                 // four vertices with vectors for building the AABB box
-	PEStaticVector<Matrix4x4, 4> m_boundingBoxAfterTransform;   // four real world vertices with vectors for building the AABB box
-	PEStaticVector<Vector3, 8> m_boundingBoxVertex;             // eight bounding box vertices
+	const CollisionShape *m_pShape;                             // local box, usually shared with other instances of the mesh
+	CollisionShape *m_pOwnedShape;                              // set by buildBoundingVolume(), from s_shapePool
 	PEStaticVector<Vector3, 8> m_boundingBoxVertexAfterTransform; // eight real world bounding box vertices
-	Array<Plane> m_boundingBoxPlanes; 
-	Vector3 m_boundingBoxCenter;
-	Vector3 m_boundingBoxHalfLength;
-	Array<MeshInstance*, 1> m_collisionMeshInstance;
-	Array<Plane, 1> m_collisionPlane;
-	Array<PrimitiveTypes::Char*, 1> m_collisionSkipList;
+	PEStaticVector<Plane, 6> m_boundingBoxPlanes; 
+	// inline, so a body's lists live in its own Handle block instead of separate arena arrays.
+	// The block itself still comes from the arena like every component's; only shapes are pooled
+	PEStaticVector<MeshInstance*, PE_PHYSICS_MAX_CONTACTS> m_collisionMeshInstance;
+	PEStaticVector<Plane, PE_PHYSICS_MAX_CONTACT_PLANES> m_collisionPlane;
+	int m_numDroppedContacts; // last collisionDetectionAll(): contacts that did not fit m_collisionMeshInstance
+	int m_numDroppedPlanes;   // and planes that did not fit m_collisionPlane
+	PEStaticVector<PrimitiveTypes::Char*, PE_PHYSICS_MAX_SKIP_PREFIXES> m_collisionSkipList;
+
+	static SlabPool<CollisionShape> s_shapePool; // owned shapes of all bodies
+	static int s_numDroppedTotal; // contacts and planes dropped by all bodies since startup
 
 }; // class PhysicsManager
 
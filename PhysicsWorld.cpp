@@ -0,0 +1,206 @@
+#include "PhysicsWorld.h"
+
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+namespace PE {
+namespace Components {
+
+CharacterControllerState::CharacterControllerState()
+: m_velocity(0)
+, m_mess(0)
+, m_acceleration(0)
+, m_accelerationOfGravity(0.8f)
+, m_gravity(0)
+, m_fallingTime(0)
+, m_backward(false)
+{
+}
+
+// Cache line aligned heap block; the pointer malloc returned is kept just before it
+static void *alignedAllocate(size_t bytes)
+{
+	void *pRaw = malloc(bytes + PE_SLAB_POOL_CACHE_LINE - 1 + sizeof(void *));
+	PEASSERT(pRaw, "Physics world allocation failed");
+	void **pAligned = (void **)(((uintptr_t)(pRaw) + sizeof(void *) + PE_SLAB_POOL_CACHE_LINE - 1) & ~(uintptr_t)(PE_SLAB_POOL_CACHE_LINE - 1));
+	pAligned[-1] = pRaw;
+	return pAligned;
+}
+
+static void alignedFree(void *p)
+{
+	if (p)
+		free(((void **)(p))[-1]);
+}
+
+// Moves count elements of p into a block of newCapacity
+template <typename T>
+static void growArray(T *&p, int count, int newCapacity)
+{
+	T *pNew = (T *)(alignedAllocate(sizeof(T) * newCapacity));
+	if (count)
+		memcpy(pNew, p, sizeof(T) * count);
+	alignedFree(p);
+	p = pNew;
+}
+
+PhysicsWorld &PhysicsWorld::Instance()
+{
+	static PhysicsWorld s_world;
+	return s_world;
+}
+
+PhysicsWorld::PhysicsWorld()
+: m_minX(NULL), m_maxX(NULL), m_minY(NULL), m_maxY(NULL), m_minZ(NULL), m_maxZ(NULL)
+, m_flags(NULL)
+, m_centerX(NULL), m_centerY(NULL), m_centerZ(NULL)
+, m_halfLengthX(NULL), m_halfLengthY(NULL), m_halfLengthZ(NULL)
+, m_pBodies(NULL)
+, m_nextFreeBody(NULL)
+, m_firstFreeBody(-1)
+, m_numBodies(0)
+, m_bodyCapacity(0)
+, m_controllers(NULL)
+, m_nextFreeController(NULL)
+, m_firstFreeController(-1)
+, m_numControllers(0)
+, m_controllerCapacity(0)
+{
+	growBodies();
+	growControllers();
+}
+
+PhysicsWorld::~PhysicsWorld()
+{
+	alignedFree(m_minX); alignedFree(m_maxX);
+	alignedFree(m_minY); alignedFree(m_maxY);
+	alignedFree(m_minZ); alignedFree(m_maxZ);
+	alignedFree(m_flags);
+	alignedFree(m_centerX); alignedFree(m_centerY); alignedFree(m_centerZ);
+	alignedFree(m_halfLengthX); alignedFree(m_halfLengthY); alignedFree(m_halfLengthZ);
+	alignedFree(m_pBodies);
+	alignedFree(m_nextFreeBody);
+
+	delete[] m_controllers;
+	alignedFree(m_nextFreeController);
+}
+
+void PhysicsWorld::growBodies()
+{
+	const int capacity = m_bodyCapacity ? m_bodyCapacity * 2 : PE_PHYSICS_WORLD_INITIAL_BODIES;
+	growArray(m_minX, m_numBodies, capacity); growArray(m_maxX, m_numBodies, capacity);
+	growArray(m_minY, m_numBodies, capacity); growArray(m_maxY, m_numBodies, capacity);
+	growArray(m_minZ, m_numBodies, capacity); growArray(m_maxZ, m_numBodies, capacity);
+	growArray(m_flags, m_numBodies, capacity);
+	growArray(m_centerX, m_numBodies, capacity); growArray(m_centerY, m_numBodies, capacity); growArray(m_centerZ, m_numBodies, capacity);
+	growArray(m_halfLengthX, m_numBodies, capacity); growArray(m_halfLengthY, m_numBodies, capacity); growArray(m_halfLengthZ, m_numBodies, capacity);
+	growArray(m_pBodies, m_numBodies, capacity);
+	growArray(m_nextFreeBody, m_numBodies, capacity);
+	m_bodyCapacity = capacity;
+}
+
+void PhysicsWorld::growControllers()
+{
+	const int capacity = m_controllerCapacity ? m_controllerCapacity * 2 : PE_PHYSICS_WORLD_INITIAL_CONTROLLERS;
+	CharacterControllerState *pControllers = new CharacterControllerState[capacity];
+	for (int i = 0; i < m_numControllers; ++i)
+		pControllers[i] = m_controllers[i];
+	delete[] m_controllers;
+	m_controllers = pControllers;
+
+	growArray(m_nextFreeController, m_numControllers, capacity);
+	m_controllerCapacity = capacity;
+}
+
+int PhysicsWorld::addBody(PhysicsManager *pPM)
+{
+	int body = m_firstFreeBody;
+	if (body != -1)
+	{
+		m_firstFreeBody = m_nextFreeBody[body];
+	}
+	else
+	{
+		if (m_numBodies == m_bodyCapacity)
+			growBodies();
+		body = m_numBodies++;
+	}
+
+	m_pBodies[body] = pPM;
+	m_flags[body] = 0;
+	// empty box until the first setBounds(), never overlaps
+	setBounds(body, FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX);
+	setCenterAndHalfLength(body, Vector3(), Vector3());
+	return body;
+}
+
+void PhysicsWorld::removeBody(int body)
+{
+	m_pBodies[body] = NULL;
+	m_flags[body] = 0;
+	setBounds(body, FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX);
+
+	m_nextFreeBody[body] = m_firstFreeBody;
+	m_firstFreeBody = body;
+}
+
+int PhysicsWorld::addController()
+{
+	int controller = m_firstFreeController;
+	if (controller != -1)
+	{
+		m_firstFreeController = m_nextFreeController[controller];
+	}
+	else
+	{
+		if (m_numControllers == m_controllerCapacity)
+			growControllers();
+		controller = m_numControllers++;
+	}
+
+	m_controllers[controller] = CharacterControllerState();
+	return controller;
+}
+
+void PhysicsWorld::removeController(int controller)
+{
+	m_nextFreeController[controller] = m_firstFreeController;
+	m_firstFreeController = controller;
+}
+
+void PhysicsWorld::setBounds(int body, float minX, float maxX, float minY, float maxY, float minZ, float maxZ)
+{
+	m_minX[body] = minX; m_maxX[body] = maxX;
+	m_minY[body] = minY; m_maxY[body] = maxY;
+	m_minZ[body] = minZ; m_maxZ[body] = maxZ;
+}
+
+void PhysicsWorld::setCenterAndHalfLength(int body, const Vector3 &center, const Vector3 &halfLength)
+{
+	m_centerX[body] = center.m_x; m_centerY[body] = center.m_y; m_centerZ[body] = center.m_z;
+	m_halfLengthX[body] = halfLength.m_x; m_halfLengthY[body] = halfLength.m_y; m_halfLengthZ[body] = halfLength.m_z;
+}
+
+int PhysicsWorld::queryOverlaps(int body, PrimitiveTypes::UInt32 flags, int *pResults, int maxResults) const
+{
+	const float minX = m_minX[body], maxX = m_maxX[body];
+	const float minY = m_minY[body], maxY = m_maxY[body];
+	const float minZ = m_minZ[body], maxZ = m_maxZ[body];
+
+	int numResults = 0;
+	for (int i = 0; i < m_numBodies; ++i)
+	{
+		// branch free interval tests over the coordinate arrays; free and unbuilt slots have empty boxes
+		const bool overlaps = (m_minX[i] <= maxX) & (minX <= m_maxX[i])
+			& (m_minY[i] <= maxY) & (minY <= m_maxY[i])
+			& (m_minZ[i] <= maxZ) & (minZ <= m_maxZ[i]);
+		if (overlaps && (m_flags[i] & flags) && i != body && numResults < maxResults)
+			pResults[numResults++] = i;
+	}
+	return numResults;
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,115 @@
+#ifndef _CHARACTER_CONTROL_PHYSICS_WORLD_
+#define _CHARACTER_CONTROL_PHYSICS_WORLD_
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Math/Plane.h"
+#include "SlabPool.h"
+
+// initial capacities; both stores double when full
+#define PE_PHYSICS_WORLD_INITIAL_BODIES 1024
+#define PE_PHYSICS_WORLD_INITIAL_CONTROLLERS 64
+
+// PhysicsWorld body flags
+#define PE_PHYSICS_BODY_MESH_INSTANCE 1 // static scene geometry other bodies collide with
+
+namespace PE {
+namespace Components {
+
+struct PhysicsManager;
+
+// Movement state of a character driven by a PhysicsManager; only characters have one
+struct CharacterControllerState
+{
+	CharacterControllerState();
+
+	Vector3 m_moveAfterBackWard;
+	Vector3 m_moveBackWard;
+	Vector3 m_moveDodge;
+	Plane m_curCollisionPlane;
+	float m_velocity;
+	float m_mess;
+	float m_acceleration;
+	float m_accelerationOfGravity;
+	float m_gravity;
+	float m_fallingTime;
+	bool m_backward;
+};
+
+// Body data of all PhysicsManagers, structure of arrays.
+// The world boxes swept by the broadphase are one cache line aligned array per coordinate;
+// character movement state is kept apart in its own store, indexed separately.
+// Both grow by doubling outside the arena (like SlabPool), so indices stay valid but pointers and
+// references into the world only last until the next addBody() / addController().
+// Game thread only
+struct PhysicsWorld
+{
+	static PhysicsWorld &Instance();
+
+	int addBody(PhysicsManager *pPM);
+	void removeBody(int body);
+
+	int addController();
+	void removeController(int controller);
+	CharacterControllerState &getController(int controller) { return m_controllers[controller]; }
+
+	void setFlags(int body, PrimitiveTypes::UInt32 flags) { m_flags[body] = flags; }
+
+	void setBounds(int body, float minX, float maxX, float minY, float maxY, float minZ, float maxZ);
+	void setCenterAndHalfLength(int body, const Vector3 &center, const Vector3 &halfLength);
+
+	Vector3 getCenter(int body) const { return Vector3(m_centerX[body], m_centerY[body], m_centerZ[body]); }
+	Vector3 getHalfLength(int body) const { return Vector3(m_halfLengthX[body], m_halfLengthY[body], m_halfLengthZ[body]); }
+	PhysicsManager *getBody(int body) const { return m_pBodies[body]; }
+
+	// Bodies with any of flags whose world box overlaps body's, other than body; returns the count
+	int queryOverlaps(int body, PrimitiveTypes::UInt32 flags, int *pResults, int maxResults) const;
+
+	int getNumBodies() const { return m_numBodies; }
+
+private:
+	PhysicsWorld();
+	~PhysicsWorld();
+	PhysicsWorld(const PhysicsWorld &);
+	PhysicsWorld &operator=(const PhysicsWorld &);
+
+	void growBodies();
+	void growControllers();
+
+	// every body array has m_bodyCapacity entries and starts on a cache line
+
+	// hot: broadphase
+	float *m_minX;
+	float *m_maxX;
+	float *m_minY;
+	float *m_maxY;
+	float *m_minZ;
+	float *m_maxZ;
+	PrimitiveTypes::UInt32 *m_flags;
+
+	// hot: narrowphase
+	float *m_centerX;
+	float *m_centerY;
+	float *m_centerZ;
+	float *m_halfLengthX;
+	float *m_halfLengthY;
+	float *m_halfLengthZ;
+
+	// cold
+	PhysicsManager **m_pBodies;
+	int *m_nextFreeBody;
+	int m_firstFreeBody;
+	int m_numBodies; // slots in use or freed, the range swept
+	int m_bodyCapacity;
+
+	CharacterControllerState *m_controllers;
+	int *m_nextFreeController;
+	int m_firstFreeController;
+	int m_numControllers;
+	int m_controllerCapacity;
+};
+
+}; // namespace Components
+}; // namespace PE
+#endif
@@ -1,6 +1,8 @@
 #ifndef __PYENGINE_2_0_PLANE_H__
 #define __PYENGINE_2_0_PLANE_H__
 
+#include <math.h>
+
 #include "Vector3.h"
 
 // Uses the implicit form: ax + by + cz + d = 0 (not ax + by + cz = d)
@@ -22,6 +24,22 @@ struct Plane
 		d = (a * p.getX() + b * p.getY() + c * p.getZ()) * -1;
 	}
 
+	// scale so that (a, b, c) has unit length; plane values are then signed distances in world units
+	void normalizeLength()
+	{
+		float len = sqrtf(a * a + b * b + c * c);
+		if (len > 0.0f)
+		{
+			float invLen = 1.0f / len;
+			a *= invLen; b *= invLen; c *= invLen; d *= invLen;
+		}
+	}
+
+	float signedDistance(const Vector3 &p) const
+	{
+		return a * p.getX() + b * p.getY() + c * p.getZ() + d;
+	}
+
 	bool checkPlaneIntersect(Plane &target)
 	{
 		return !(getN().crossProduct(target.getN()) == Vector3());
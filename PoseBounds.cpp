@@ -0,0 +1,87 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <float.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "PoseBounds.h"
+
+// the SSE switch is defined by the header above
+#if PE_POSE_BOUNDS_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace PE {
+namespace Components {
+
+void PoseBounds::computeJointBounds(const Matrix4x4 *pPalette, int numJoints, Vector3 &outMin, Vector3 &outMax)
+{
+	if (numJoints <= 0)
+	{
+		outMin = outMax = Vector3(0, 0, 0);
+		return;
+	}
+
+#if PE_POSE_BOUNDS_USE_SSE
+	// x, y, z of one joint per register; the 4th lane is padding
+	__m128 vMin = _mm_set1_ps(FLT_MAX);
+	__m128 vMax = _mm_set1_ps(-FLT_MAX);
+
+	for (int i = 0; i < numJoints; ++i)
+	{
+		const Vector3 p = pPalette[i].getPos();
+		const __m128 v = _mm_set_ps(0.0f, p.m_z, p.m_y, p.m_x);
+		vMin = _mm_min_ps(vMin, v);
+		vMax = _mm_max_ps(vMax, v);
+	}
+
+	float mn[4], mx[4];
+	_mm_storeu_ps(mn, vMin);
+	_mm_storeu_ps(mx, vMax);
+	outMin = Vector3(mn[0], mn[1], mn[2]);
+	outMax = Vector3(mx[0], mx[1], mx[2]);
+#else
+	float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX, maxZ = -FLT_MAX;
+	for (int i = 0; i < numJoints; ++i)
+	{
+		const Vector3 p = pPalette[i].getPos();
+		if (p.m_x < minX) minX = p.m_x;
+		if (p.m_x > maxX) maxX = p.m_x;
+		if (p.m_y < minY) minY = p.m_y;
+		if (p.m_y > maxY) maxY = p.m_y;
+		if (p.m_z < minZ) minZ = p.m_z;
+		if (p.m_z > maxZ) maxZ = p.m_z;
+	}
+	outMin = Vector3(minX, minY, minZ);
+	outMax = Vector3(maxX, maxY, maxZ);
+#endif
+}
+
+void PoseBounds::transformBounds(const Matrix4x4 &transform, const Vector3 &localMin, const Vector3 &localMax,
+	Vector3 &outMin, Vector3 &outMax)
+{
+	const Vector3 localCenter = (localMin + localMax) * 0.5f;
+	const Vector3 localHalf = (localMax - localMin) * 0.5f;
+
+	const Vector3 center = transform * localCenter;
+	const Vector3 u = transform.getU() * localHalf.m_x;
+	const Vector3 v = transform.getV() * localHalf.m_y;
+	const Vector3 n = transform.getN() * localHalf.m_z;
+
+	// extent along each world axis is the sum of the projected half axes
+	const Vector3 half(
+		fabsf(u.m_x) + fabsf(v.m_x) + fabsf(n.m_x),
+		fabsf(u.m_y) + fabsf(v.m_y) + fabsf(n.m_y),
+		fabsf(u.m_z) + fabsf(v.m_z) + fabsf(n.m_z));
+
+	outMin = center - half;
+	outMax = center + half;
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,41 @@
+#ifndef __PYENGINE_2_0_POSE_BOUNDS_H__
+#define __PYENGINE_2_0_POSE_BOUNDS_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Math/Vector3.h"
+
+// Sibling/Children includes
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+#define PE_POSE_BOUNDS_USE_SSE 1
+#else
+#define PE_POSE_BOUNDS_USE_SSE 0
+#endif
+
+namespace PE {
+namespace Components {
+
+// Bounds of an animated pose, computed once per animation update so that culling and physics
+// do not depend on the debug skeleton drawing
+struct PoseBounds
+{
+	// Min/max reduction over the joint positions of a model space palette
+	static void computeJointBounds(const Matrix4x4 *pPalette, int numJoints, Vector3 &outMin, Vector3 &outMax);
+
+	// Axis aligned box that contains the box min/max placed by transform
+	static void transformBounds(const Matrix4x4 &transform, const Vector3 &localMin, const Vector3 &localMax,
+		Vector3 &outMin, Vector3 &outMax);
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
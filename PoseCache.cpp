@@ -0,0 +1,199 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+#include <math.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "PoseCache.h"
+#include "PaletteOps.h"
+
+namespace PE {
+namespace Components {
+
+// Static member variables
+PoseCache *PoseCache::s_pInstance = NULL;
+Handle PoseCache::s_hInstance;
+
+void PoseCacheKey::clear()
+{
+	m_pSkeleton = NULL;
+	m_numSlots = 0;
+	m_hash = 0;
+}
+
+bool PoseCacheKey::addSlot(const void *pAnimSet, PrimitiveTypes::UInt32 animationIndex, PrimitiveTypes::Float32 frame,
+	PrimitiveTypes::Float32 weight, PrimitiveTypes::UInt32 flags)
+{
+	if (m_numSlots == PE_POSE_CACHE_MAX_KEY_SLOTS)
+		return false;
+
+	Slot &slot = m_slots[m_numSlots++];
+	slot.m_pAnimSet = pAnimSet;
+	slot.m_animationIndex = animationIndex;
+	slot.m_quantizedFrame = (PrimitiveTypes::Int32)(floorf(frame * PoseCache::FrameQuantization()));
+	slot.m_quantizedWeight = (PrimitiveTypes::UInt32)(weight * 256.0f + 0.5f);
+	slot.m_flags = flags;
+	return true;
+}
+
+// FNV-1a step over one field
+static inline void hashBytes(PrimitiveTypes::UInt64 &h, const void *pData, size_t size)
+{
+	const unsigned char *p = (const unsigned char *)(pData);
+	for (size_t i = 0; i < size; ++i)
+	{
+		h ^= p[i];
+		h *= 1099511628211ull;
+	}
+}
+
+PrimitiveTypes::UInt64 PoseCacheKey::computeHash() const
+{
+	// field by field, so struct padding and unused slots never take part
+	PrimitiveTypes::UInt64 h = 14695981039346656037ull;
+	hashBytes(h, &m_pSkeleton, sizeof(m_pSkeleton));
+	hashBytes(h, &m_numSlots, sizeof(m_numSlots));
+	for (int i = 0; i < m_numSlots; ++i)
+	{
+		const Slot &slot = m_slots[i];
+		hashBytes(h, &slot.m_pAnimSet, sizeof(slot.m_pAnimSet));
+		hashBytes(h, &slot.m_animationIndex, sizeof(slot.m_animationIndex));
+		hashBytes(h, &slot.m_quantizedFrame, sizeof(slot.m_quantizedFrame));
+		hashBytes(h, &slot.m_quantizedWeight, sizeof(slot.m_quantizedWeight));
+		hashBytes(h, &slot.m_flags, sizeof(slot.m_flags));
+	}
+	return h;
+}
+
+bool PoseCacheKey::operator==(const PoseCacheKey &other) const
+{
+	if (m_hash != other.m_hash || m_pSkeleton != other.m_pSkeleton || m_numSlots != other.m_numSlots)
+		return false;
+
+	for (int i = 0; i < m_numSlots; ++i)
+	{
+		const Slot &a = m_slots[i];
+		const Slot &b = other.m_slots[i];
+		if (a.m_pAnimSet != b.m_pAnimSet || a.m_animationIndex != b.m_animationIndex ||
+			a.m_quantizedFrame != b.m_quantizedFrame || a.m_quantizedWeight != b.m_quantizedWeight || a.m_flags != b.m_flags)
+			return false;
+	}
+	return true;
+}
+
+PoseCache::PoseCache(PE::GameContext &context, PE::MemoryArena arena)
+: m_palettes(context, arena)
+, m_useCounter(0)
+{
+	memset(m_entries, 0, sizeof(m_entries));
+	memset(&m_stats, 0, sizeof(m_stats));
+
+	m_palettes.reset(PE_POSE_CACHE_MAX_ENTRIES * PE_POSE_CACHE_MAX_JOINTS);
+	m_palettes.m_size = PE_POSE_CACHE_MAX_ENTRIES * PE_POSE_CACHE_MAX_JOINTS;
+}
+
+void PoseCache::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle handle("POSE_CACHE", sizeof(PoseCache));
+	s_pInstance = new(handle) PoseCache(context, arena);
+	s_hInstance = handle;
+}
+
+PrimitiveTypes::Float32 &PoseCache::FrameQuantization()
+{
+	// 16 steps keep the snap under a frame's sixteenth, too small to see at 30 fps clips
+	static PrimitiveTypes::Float32 s_stepsPerFrame = 16.0f;
+	return s_stepsPerFrame;
+}
+
+bool &PoseCache::Enabled()
+{
+	static bool s_enabled = true;
+	return s_enabled;
+}
+
+int PoseCache::findEntry(const PoseCacheKey &key) const
+{
+	for (int i = 0; i < PE_POSE_CACHE_MAX_ENTRIES; ++i)
+	{
+		if (m_entries[i].m_numJoints && m_entries[i].m_key == key)
+			return i;
+	}
+	return -1;
+}
+
+bool PoseCache::lookup(const PoseCacheKey &key, Matrix4x4 *pPalette, int numJoints)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const int i = findEntry(key);
+	if (i < 0 || m_entries[i].m_numJoints != numJoints)
+	{
+		++m_stats.m_numMisses;
+		return false;
+	}
+
+	m_entries[i].m_lastUse = ++m_useCounter;
+	PaletteOps::unpack(&m_palettes[i * PE_POSE_CACHE_MAX_JOINTS], pPalette, numJoints);
+	++m_stats.m_numHits;
+	return true;
+}
+
+void PoseCache::insert(const PoseCacheKey &key, const Matrix4x4 *pPalette, int numJoints)
+{
+	if (numJoints <= 0 || numJoints > PE_POSE_CACHE_MAX_JOINTS)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// another thread may have inserted the same pose meanwhile
+	int iEntry = findEntry(key);
+	if (iEntry < 0)
+	{
+		// free entry or least recently used one
+		iEntry = 0;
+		for (int i = 0; i < PE_POSE_CACHE_MAX_ENTRIES; ++i)
+		{
+			if (m_entries[i].m_numJoints == 0)
+			{
+				iEntry = i;
+				break;
+			}
+			if (m_entries[i].m_lastUse < m_entries[iEntry].m_lastUse)
+				iEntry = i;
+		}
+		if (m_entries[iEntry].m_numJoints)
+			++m_stats.m_numEvictions;
+	}
+
+	Entry &e = m_entries[iEntry];
+	e.m_key = key;
+	e.m_numJoints = numJoints;
+	e.m_lastUse = ++m_useCounter;
+	PaletteOps::pack(pPalette, &m_palettes[iEntry * PE_POSE_CACHE_MAX_JOINTS], numJoints);
+}
+
+void PoseCache::noteUncacheable()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	++m_stats.m_numUncacheable;
+}
+
+PoseCacheStats PoseCache::getStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void PoseCache::resetStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,110 @@
+#ifndef __PYENGINE_2_0_POSE_CACHE_H__
+#define __PYENGINE_2_0_POSE_CACHE_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+#include <mutex>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+
+// Sibling/Children includes
+#include "AffineMatrix3x4.h"
+
+#define PE_POSE_CACHE_MAX_ENTRIES 64
+#define PE_POSE_CACHE_MAX_JOINTS 128   // skeletons with more joints are not cached
+#define PE_POSE_CACHE_MAX_KEY_SLOTS 4  // poses blended from more active slots are not cached
+
+namespace PE {
+namespace Components {
+
+// Identifies an evaluated pose: skeleton, and for every active slot the animation set, clip,
+// quantized frame, quantized weight and flags
+struct PoseCacheKey
+{
+	struct Slot
+	{
+		const void *m_pAnimSet;
+		PrimitiveTypes::UInt32 m_animationIndex;
+		PrimitiveTypes::Int32 m_quantizedFrame;
+		PrimitiveTypes::UInt32 m_quantizedWeight;
+		PrimitiveTypes::UInt32 m_flags;
+	};
+
+	PoseCacheKey() { clear(); }
+	void clear();
+
+	// returns false when the pose has too many slots to be cached
+	bool addSlot(const void *pAnimSet, PrimitiveTypes::UInt32 animationIndex, PrimitiveTypes::Float32 frame,
+		PrimitiveTypes::Float32 weight, PrimitiveTypes::UInt32 flags);
+
+	PrimitiveTypes::UInt64 computeHash() const;
+	void finalize() { m_hash = computeHash(); } // after the last addSlot()
+	bool operator==(const PoseCacheKey &other) const;
+
+	const void *m_pSkeleton;
+	int m_numSlots;
+	Slot m_slots[PE_POSE_CACHE_MAX_KEY_SLOTS];
+	PrimitiveTypes::UInt64 m_hash; // set by finalize()
+};
+
+struct PoseCacheStats
+{
+	PrimitiveTypes::UInt32 m_numHits;
+	PrimitiveTypes::UInt32 m_numMisses;
+	PrimitiveTypes::UInt32 m_numEvictions;
+	PrimitiveTypes::UInt32 m_numUncacheable;
+};
+
+// Model space palettes shared by all skeleton instances playing the same clips at the same
+// (quantized) frame. Fixed number of entries with LRU replacement; safe to use from job pool threads.
+struct PoseCache
+{
+	PoseCache(PE::GameContext &context, PE::MemoryArena arena);
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static PoseCache *Instance() { return s_pInstance; }
+
+	// Frame sub-steps a key is quantized to. 1 snaps every instance to whole frames (more hits),
+	// larger values keep more of the original timing
+	static PrimitiveTypes::Float32 &FrameQuantization();
+	static bool &Enabled();
+
+	// Copies the cached palette into pPalette and returns true on a hit
+	bool lookup(const PoseCacheKey &key, Matrix4x4 *pPalette, int numJoints);
+	void insert(const PoseCacheKey &key, const Matrix4x4 *pPalette, int numJoints);
+
+	void noteUncacheable();
+	PoseCacheStats getStats();
+	void resetStats();
+
+private:
+	struct Entry
+	{
+		PoseCacheKey m_key;
+		int m_numJoints; // 0 = free
+		PrimitiveTypes::UInt32 m_lastUse;
+	};
+
+	int findEntry(const PoseCacheKey &key) const;
+
+	Entry m_entries[PE_POSE_CACHE_MAX_ENTRIES];
+	Array<AffineMatrix3x4> m_palettes; // PE_POSE_CACHE_MAX_JOINTS per entry, allocated once
+	PrimitiveTypes::UInt32 m_useCounter;
+	PoseCacheStats m_stats;
+	std::mutex m_mutex;
+
+	static PoseCache *s_pInstance;
+	static Handle s_hInstance;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
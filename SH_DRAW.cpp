@@ -4,6 +4,7 @@
 #include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
 
 // Outer-Engine includes
+#include <string.h>
 
 // Inter-Engine includes
 #include "PrimeEngine/FileSystem/FileReader.h"
@@ -36,6 +37,10 @@
 #include "DebugRenderer.h"
 #include "CameraManager.h"
 #include "CameraSceneNode.h"
+#include "FrustumCulling.h"
+#include "DebugLineStream.h"
+#include "AnimationSystem.h"
+#include "AnimationLod.h"
 
 #include "SH_DRAW.h"
 #include "CharacterControl/PhysicsManager.h"
@@ -159,6 +164,73 @@ void MeshHelpers::setZOnlyEffectOfTopEffectSecuence(Mesh *pObj, Handle hNewEffec
 	}
 }
 
+// Visible bounding boxes drawn per addBoxes() call
+#define PE_DEBUG_BOX_BATCH_SIZE 32
+static const Vector3 s_debugBoxColor(0.0f, 1.0f, 0.0f);
+
+// ---------- LOD selection ----------
+
+// Used when a mesh does not provide Mesh::m_lodScreenSizes.
+static const PrimitiveTypes::Float32 s_defaultLodScreenSizes[PE_MAX_MESH_LOD_COUNT] = { 0.25f, 0.12f, 0.06f, 0.03f };
+
+// An instance has to be this fraction past a threshold before it changes level (avoids popping at the boundary).
+static const PrimitiveTypes::Float32 s_lodHysteresis = 0.15f;
+
+static int getNumLodBuckets(Mesh *pMesh)
+{
+	int numLods = pMesh->m_lods.m_size;
+	if (numLods > PE_MAX_MESH_LOD_COUNT)
+		numLods = PE_MAX_MESH_LOD_COUNT;
+	return numLods + 1;
+}
+
+static PrimitiveTypes::Float32 getLodScreenSize(Mesh *pMesh, int iLod)
+{
+	if (iLod < (int)(pMesh->m_lodScreenSizes.m_size))
+		return pMesh->m_lodScreenSizes[iLod];
+	return s_defaultLodScreenSizes[iLod];
+}
+
+// Picks the LOD bucket from projected size (bounding radius over half of the view height at that distance).
+static int selectLodLevel(Mesh *pMesh, int curLevel, PrimitiveTypes::Float32 radius, PrimitiveTypes::Float32 distance, PrimitiveTypes::Float32 tanHalfFov)
+{
+	const int maxLevel = getNumLodBuckets(pMesh) - 1;
+	if (maxLevel == 0)
+		return 0;
+
+	const PrimitiveTypes::Float32 screenSize = (distance * tanHalfFov > 0.0001f) ? radius / (distance * tanHalfFov) : FLT_MAX;
+
+	if (curLevel > maxLevel)
+		curLevel = maxLevel;
+
+	while (curLevel < maxLevel && screenSize < getLodScreenSize(pMesh, curLevel) * (1.0f - s_lodHysteresis))
+		++curLevel;
+	while (curLevel > 0 && screenSize > getLodScreenSize(pMesh, curLevel - 1) * (1.0f + s_lodHysteresis))
+		--curLevel;
+
+	return curLevel;
+}
+
+static bool isInstanceInLodBucket(MeshInstance *pInst, int iLod, int numLodBuckets)
+{
+	if (pInst->m_culledOut)
+		return false;
+	return numLodBuckets == 1 || pInst->m_lodLevel == iLod;
+}
+
+// Returns index of the instance after skipping numToSkip instances of the bucket, starting at iStart.
+static int skipInstancesInLodBucket(Mesh *pMesh, int iStart, int numToSkip, int iLod, int numLodBuckets)
+{
+	int i = iStart;
+	while (numToSkip > 0 && i < (int)(pMesh->m_instances.m_size))
+	{
+		if (isInstanceInLodBucket(pMesh->m_instances[i].getObject<MeshInstance>(), iLod, numLodBuckets))
+			--numToSkip;
+		++i;
+	}
+	return i;
+}
+
 // ---------- SingleHandler_DRAW (singleton) ----------
 
 PE_IMPLEMENT_SINGLETON_CLASS1(SingleHandler_DRAW, Component);
@@ -170,6 +242,9 @@ void SingleHandler_DRAW::do_GATHER_DRAWCALLS(Events::Event *pEvt)
 	if (pMeshCaller->m_instances.m_size == 0)
 		return; // nothing to draw
 
+	// skinned instances read animation palettes below; no-op once they are evaluated this frame
+	AnimationSystem::Instance()->flush();
+
 	Events::Event_GATHER_DRAWCALLS *pDrawEvent = NULL;
 	Events::Event_GATHER_DRAWCALLS_Z_ONLY *pZOnlyDrawEvent = NULL;
 
@@ -181,18 +256,34 @@ void SingleHandler_DRAW::do_GATHER_DRAWCALLS(Events::Event *pEvt)
 	// Assume visible; may be reduced by frustum culling.
 	pMeshCaller->m_numVisibleInstances = pMeshCaller->m_instances.m_size;
 
+	const int numLodBuckets = getNumLodBuckets(pMeshCaller);
+	for (int iLod = 0; iLod < numLodBuckets; ++iLod)
+		pMeshCaller->m_numVisibleInstancesPerLod[iLod] = 0;
+
 	// Per-instance frustum check using per-mesh AABB (PhysicsManager).
 	if (pMeshCaller->m_performBoundingVolumeCulling)
 	{
 		pMeshCaller->m_numVisibleInstances = 0;
 
+		// Active camera
+		CameraSceneNode *pCam = CameraManager::Instance()->getActiveCamera()->getCamSceneNode();
+		const PrimitiveTypes::Float32 tanHalfFov = tan(pCam->m_verticalFov * 0.5f);
+
+		// All registered views are tested in one pass; this event draws from the main view or the Z-only view.
+		MultiViewCuller &views = MultiViewCuller::FrameViews();
+		views.setView(PE_CULLING_VIEW_MAIN, pCam->m_frustumPlanes);
+		views.setCollectStats(pDrawEvent != NULL); // the Z-only pass repeats the main pass' tests
+		const PrimitiveTypes::UInt32 eventViewBit = 1u << (pDrawEvent ? PE_CULLING_VIEW_MAIN : views.m_zOnlyView);
+
+		// Wireframes of visible boxes are batched and emitted as whole boxes; only the main pass draws them
+		Vector3 debugBoxCorners[8 * PE_DEBUG_BOX_BATCH_SIZE];
+		int numDebugBoxes = 0;
+		DebugLineStream *pDebugLines = pDrawEvent ? DebugLineStream::Instance() : NULL;
+
 		for (int iInst = 0; iInst < pMeshCaller->m_instances.m_size; ++iInst)
 		{
 			MeshInstance *pInst = pMeshCaller->m_instances[iInst].getObject<MeshInstance>();
 
-			// Active camera
-			CameraSceneNode *pCam = CameraManager::Instance()->getActiveCamera()->getCamSceneNode();
-
 			// Resolve SceneNode for this instance. Skinned soldier uses a deeper chain.
 			SceneNode *pCurrentSN = pInst->getFirstParentByTypePtr<SceneNode>();
 			SkeletonInstance *pSI = NULL;
@@ -205,38 +296,48 @@ void SingleHandler_DRAW::do_GATHER_DRAWCALLS(Events::Event *pEvt)
 					SceneNode *pRotateSN = pSI->getFirstParentByTypePtr<SceneNode>();
 					SceneNode *pSN = pRotateSN->getFirstParentByTypePtr<SceneNode>();
 					pCurrentSN = pSN->getFirstParentByTypePtr<SceneNode>();
-					pInst->m_culledOut = false;
+
+					// pose bounds are in the space of the skeleton's scene node
+					PrimitiveTypes::Float32 nearDistance = 0.0f;
+					if (pSI->m_hasPoseBounds)
+					{
+						pInst->m_visibilityMask = views.testOBB(pRotateSN->m_worldTransform,
+							pSI->m_poseBoundsMin, pSI->m_poseBoundsMax, pInst->m_cullState, &nearDistance);
+					}
+					else
+					{
+						pInst->m_visibilityMask = views.getAllViewsMask();
+					}
+					pInst->m_culledOut = !(pInst->m_visibilityMask & eventViewBit);
+
+					// drives the animation update rate of the next frame; seen by any view (shadows too) counts as visible
+					if (pDrawEvent)
+					{
+						AnimationLod::reportVisibility(pSI->m_animLod, pInst->m_visibilityMask != 0,
+							nearDistance + pCam->m_near, AnimationSystem::Instance()->getFrameIndex());
+					}
+
+					if (pInst->m_culledOut)
+						continue;
+
+					pInst->m_lodLevel = 0; // skinned meshes always draw full detail (bone segments are per mesh)
 					++pMeshCaller->m_numVisibleInstances;
+					++pMeshCaller->m_numVisibleInstancesPerLod[0];
 				}
 			}
 			else
 			{
 				// Retrieve AABB info from PhysicsManager.
 				PhysicsManager *pPhyManager = pInst->getFirstComponent<PhysicsManager>();
-				pInst->m_culledOut = true;
-
 				const Matrix4x4 worldMatrix = pCurrentSN->m_worldTransform;
 
-				// Vertex-against-frustum test: if any AABB vertex lies inside all 6 planes, keep the instance.
-				bool anyVertexInside = false;
-				const int kNumPlanes = 6;
-				for (int vIndex = 0; vIndex < 8 && !anyVertexInside; ++vIndex)
-				{
-					Vector3 vtxT = worldMatrix * pPhyManager->m_boundingBoxVertex[vIndex];
+				// Box-against-frustums test: the box is rejected by a view only if it is fully behind one of its planes.
+				PrimitiveTypes::Float32 nearDistance = 0.0f;
+				pInst->m_visibilityMask = views.testOBB(worldMatrix,
+					pPhyManager->m_pShape->m_vertices[0], pPhyManager->m_pShape->m_vertices[7],
+					pInst->m_cullState, &nearDistance);
 
-					int insideCount = 0;
-					for (int ip = 0; ip < kNumPlanes; ++ip)
-					{
-						if (pCam->m_frustumPlanes[ip].isInsidePlane(vtxT))
-							++insideCount;
-						else
-							break; // fails this plane
-					}
-					if (insideCount == kNumPlanes)
-						anyVertexInside = true;
-				}
-
-				pInst->m_culledOut = !anyVertexInside;
+				pInst->m_culledOut = !(pInst->m_visibilityMask & eventViewBit);
 
 				// Keep PhysicsManager's post-transform data fresh for debug draw / collisions.
 				pPhyManager->buildBoundingVolumeAfterTransform(worldMatrix);
@@ -247,16 +348,32 @@ void SingleHandler_DRAW::do_GATHER_DRAWCALLS(Events::Event *pEvt)
 				// Visible instance.
 				++pMeshCaller->m_numVisibleInstances;
 
-				// Optional: draw AABB wireframe using 4 edge frames.
-				for (int i = 0; i < 4; ++i)
+				// Bucket by projected size of the world bounds; planes are unit length so nearDistance is in world units.
+				const PrimitiveTypes::Float32 radius = (pPhyManager->m_boundingBoxVertexAfterTransform[7] - pPhyManager->m_boundingBoxVertexAfterTransform[0]).length() * 0.5f;
+				const PrimitiveTypes::Float32 distance = nearDistance + pCam->m_near;
+				pInst->m_lodLevel = selectLodLevel(pMeshCaller, pInst->m_lodLevel, radius, distance, tanHalfFov);
+				++pMeshCaller->m_numVisibleInstancesPerLod[pInst->m_lodLevel];
+
+				if (pDebugLines)
 				{
-					DebugRenderer::Instance()->createAABBLineMesh(
-						true,
-						pPhyManager->m_boundingBoxAfterTransform[i],
-						NULL, 0, 0);
+					memcpy(&debugBoxCorners[8 * numDebugBoxes], &pPhyManager->m_boundingBoxVertexAfterTransform[0], sizeof(Vector3) * 8);
+					if (++numDebugBoxes == PE_DEBUG_BOX_BATCH_SIZE)
+					{
+						pDebugLines->addBoxes(debugBoxCorners, numDebugBoxes, s_debugBoxColor, 0);
+						numDebugBoxes = 0;
+					}
 				}
 			}
 		}
+
+		if (pDebugLines && numDebugBoxes)
+			pDebugLines->addBoxes(debugBoxCorners, numDebugBoxes, s_debugBoxColor, 0);
+	}
+	else
+	{
+		for (int iInst = 0; iInst < pMeshCaller->m_instances.m_size; ++iInst)
+			pMeshCaller->m_instances[iInst].getObject<MeshInstance>()->m_lodLevel = 0;
+		pMeshCaller->m_numVisibleInstancesPerLod[0] = pMeshCaller->m_numVisibleInstances;
 	}
 
 	DrawList *pDrawList = pDrawEvent ? DrawList::Instance() : DrawList::ZOnlyInstance();
@@ -402,10 +519,16 @@ void SingleHandler_DRAW::gatherDrawCallsForRange(
 	GPUMaterialSet *pGpuMatSet = pMeshCaller->m_hMaterialSetGPU.getObject<GPUMaterialSet>();
 	GPUMaterial &curMat = pGpuMatSet->m_materials[iRange];
 		
+	// Skinned meshes only have full-detail bone segments, so they are always drawn from bucket 0.
+	const int numLodBuckets = hasJointSegments ? 1 : getNumLodBuckets(pMeshCaller);
+
 	for (PrimitiveTypes::UInt32 iEffect = 0; iEffect < pEffectsForRange->m_size; ++iEffect)
 	{
 		Handle hEffect = (*pEffectsForRange)[iEffect];
 		Effect *pEffect = hEffect.getObject<Effect>();
+
+		if (pDrawEvent && pEffect->m_effectDrawOrder != pDrawEvent->m_drawOrder)
+			continue;
 		
 		int maxInstancesPerDrawCall = hasJointSegments ? PE_MAX_SKINED_INSTANCE_COUNT_IN_DRAW_CALL : PE_MAX_INSTANCE_COUNT_IN_DRAW_CALL;
 		#if PE_API_IS_D3D11
@@ -413,22 +536,15 @@ void SingleHandler_DRAW::gatherDrawCallsForRange(
 				maxInstancesPerDrawCall = PE_MAX_SKINED_INSTANCE_COUNT_IN_COMPUTE_CALL;
 		#endif
 
-		int instancePasses = 1;
-		if (haveInstancesAndInstanceEffect)
+		// Each LOD bucket is submitted with its own index/vertex buffers.
+		for (int iLod = 0; iLod < numLodBuckets; ++iLod)
 		{
-			instancePasses = (pMeshCaller->m_numVisibleInstances + maxInstancesPerDrawCall - 1) / maxInstancesPerDrawCall;
-		}
-
-		if (pDrawEvent && pEffect->m_effectDrawOrder != pDrawEvent->m_drawOrder)
-			continue;
-
-		const int numRenderGroups = haveInstancesAndInstanceEffect ? instancePasses : pMeshCaller->m_numVisibleInstances;
-
-		// Tracks which instance index we try next (can skip culled ones).
-		int iSrcInstance = 0;
+			const int numVisibleInLod = numLodBuckets > 1
+				? pMeshCaller->m_numVisibleInstancesPerLod[iLod]
+				: pMeshCaller->m_numVisibleInstances;
+			if (numVisibleInLod == 0)
+				continue;
 
-		for (int iRenderGroup = 0; iRenderGroup < numRenderGroups; ++iRenderGroup)
-		{
 			Handle hLodIB = hIBuf;
 			IndexBufferGPU *pLodibGPU = pibGPU;
 
@@ -437,120 +553,133 @@ void SingleHandler_DRAW::gatherDrawCallsForRange(
 			for (int ivbuf = 0; ivbuf < vbCount; ++ivbuf)
 				hLODVB[ivbuf] = pHVBs[ivbuf];
 
-			int numInstancesInGroup = 1;
-			if (haveInstancesAndInstanceEffect)
+			if (iLod > 0)
 			{
-				numInstancesInGroup = (iRenderGroup < instancePasses - 1)
-					? maxInstancesPerDrawCall
-					: (pMeshCaller->m_numVisibleInstances % maxInstancesPerDrawCall);
+				Mesh *pLodMesh = pMeshCaller->m_lods[iLod - 1].getObject<Mesh>();
+				hLodIB = pLodMesh->m_hIndexBufferGPU;
+				pLodibGPU = hLodIB.getObject<IndexBufferGPU>();
 
-				if (!numInstancesInGroup) numInstancesInGroup = maxInstancesPerDrawCall;
+				PEASSERT(vbCount == pLodMesh->m_vertexBuffersGPUHs.m_size, "VB count mismatch for LOD");
+				for (int ivbuf = 0; ivbuf < vbCount; ++ivbuf)
+					hLODVB[ivbuf] = pLodMesh->m_vertexBuffersGPUHs[ivbuf];
+			}
 
-				// Choose LOD for large instance groups (optional)
-				if (iRenderGroup > 0 && pMeshCaller->m_lods.m_size)
-				{
-					Mesh *pLodMesh = pMeshCaller->m_lods[0].getObject<Mesh>();
-					hLodIB = pLodMesh->m_hIndexBufferGPU;
-					pLodibGPU = hLodIB.getObject<IndexBufferGPU>();
-					
-					PEASSERT(vbCount == pLodMesh->m_vertexBuffersGPUHs.m_size, "VB count mismatch for LOD");
-					for (int ivbuf = 0; ivbuf < vbCount; ++ivbuf)
-						hLODVB[ivbuf] = pLodMesh->m_vertexBuffersGPUHs[ivbuf];
-				}
+			int instancePasses = 1;
+			if (haveInstancesAndInstanceEffect)
+			{
+				instancePasses = (numVisibleInLod + maxInstancesPerDrawCall - 1) / maxInstancesPerDrawCall;
 			}
 
-			PrimitiveTypes::UInt32 numJointSegments = hasJointSegments ? ir.m_boneSegments.m_size : 1;
-			if (g_disableSkinRender && hasJointSegments)
-				numJointSegments = 0;
+			const int numRenderGroups = haveInstancesAndInstanceEffect ? instancePasses : numVisibleInLod;
 
-			int iSrcInstanceInBoneSegment = 0;
+			// Tracks which instance index we try next (can skip culled ones and other buckets).
+			int iSrcInstance = 0;
 
-			for (PrimitiveTypes::UInt32 _iBoneSegment = 0; _iBoneSegment < numJointSegments; ++_iBoneSegment)
+			for (int iRenderGroup = 0; iRenderGroup < numRenderGroups; ++iRenderGroup)
 			{
-				PrimitiveTypes::UInt32 iBoneSegment = _iBoneSegment;
-				if (g_iDebugBoneSegment >= 0 && g_iDebugBoneSegment < numJointSegments)
+				int numInstancesInGroup = 1;
+				if (haveInstancesAndInstanceEffect)
 				{
-					iBoneSegment = g_iDebugBoneSegment;
-					if (_iBoneSegment) break;
+					numInstancesInGroup = (iRenderGroup < instancePasses - 1)
+						? maxInstancesPerDrawCall
+						: (numVisibleInLod % maxInstancesPerDrawCall);
+
+					if (!numInstancesInGroup) numInstancesInGroup = maxInstancesPerDrawCall;
 				}
 
-				// Reset instance cursor for this bone segment (we want the same instances).
-				iSrcInstanceInBoneSegment = iSrcInstance;
-				while (pMeshCaller->m_instances[iSrcInstanceInBoneSegment].getObject<MeshInstance>()->m_culledOut)
-					++iSrcInstanceInBoneSegment;
+				// First instance of this group.
+				while (!isInstanceInLodBucket(pMeshCaller->m_instances[iSrcInstance].getObject<MeshInstance>(), iLod, numLodBuckets))
+					++iSrcInstance;
 
-				pDrawList->beginDrawCallRecord(curMat.m_dbgName);
+				PrimitiveTypes::UInt32 numJointSegments = hasJointSegments ? ir.m_boneSegments.m_size : 1;
+				if (g_disableSkinRender && hasJointSegments)
+					numJointSegments = 0;
 
-				if (API_CHOOSE_DX11_DX9_OGL(pEffect->m_CS, NULL, NULL) == NULL)
+				for (PrimitiveTypes::UInt32 _iBoneSegment = 0; _iBoneSegment < numJointSegments; ++_iBoneSegment)
 				{
-					// Non-CS path
-					if (hLodIB.isValid())
-						pDrawList->setIndexBuffer(hLodIB, pLodibGPU->m_indexRanges.m_size ? iRange : -1, hasJointSegments ? iBoneSegment : -1);
+					PrimitiveTypes::UInt32 iBoneSegment = _iBoneSegment;
+					if (g_iDebugBoneSegment >= 0 && g_iDebugBoneSegment < numJointSegments)
+					{
+						iBoneSegment = g_iDebugBoneSegment;
+						if (_iBoneSegment) break;
+					}
+
+					// Every bone segment draws the same instances.
+					const int iSrcInstanceInBoneSegment = iSrcInstance;
+
+					pDrawList->beginDrawCallRecord(curMat.m_dbgName);
+
+					if (API_CHOOSE_DX11_DX9_OGL(pEffect->m_CS, NULL, NULL) == NULL)
+					{
+						// Non-CS path
+						if (hLodIB.isValid())
+							pDrawList->setIndexBuffer(hLodIB, pLodibGPU->m_indexRanges.m_size ? iRange : -1, hasJointSegments ? iBoneSegment : -1);
+						else
+							pDrawList->setIndexBuffer(Handle());
+
+						for (int ivbuf = 0; ivbuf < vbCount; ++ivbuf)
+							pDrawList->setVertexBuffer(hLODVB[ivbuf]);
+					}
 					else
+					{
+						// CS path
+						pDrawList->setVertexBuffer(Handle());
 						pDrawList->setIndexBuffer(Handle());
+					}
 
-					for (int ivbuf = 0; ivbuf < vbCount; ++ivbuf)
-						pDrawList->setVertexBuffer(hLODVB[ivbuf]);
-				}
-				else
-				{
-					// CS path
-					pDrawList->setVertexBuffer(Handle());
-					pDrawList->setIndexBuffer(Handle());
-				}
-
-				// Group size: either many (instancing) or single (non-instanced).
-				pDrawList->setInstanceCount(numInstancesInGroup, 0);
-				curMat.createShaderActions(pDrawList);
-				pDrawList->setEffect(hEffect);
+					// Group size: either many (instancing) or single (non-instanced).
+					pDrawList->setInstanceCount(numInstancesInGroup, 0);
+					curMat.createShaderActions(pDrawList);
+					pDrawList->setEffect(hEffect);
 
-				if (!haveInstancesAndInstanceEffect) // non-instanced
-				{
-					addNonInstancedTechShaderActions(
-						pMeshCaller, ir, iBoneSegment, iRenderGroup, iSrcInstanceInBoneSegment,
-						hasJointSegments, pDrawList, pEffect, evtProjectionViewWorldMatrix,
-						vbCount, vbWeights);
-				}
-				
-				if (haveInstancesAndInstanceEffect) // instanced
-				{
-					if (hasJointSegments)
+					if (!haveInstancesAndInstanceEffect) // non-instanced
 					{
-						MeshInstance *pMeshInstance = pMeshCaller->getFirstComponent<MeshInstance>();
-						#if PE_API_IS_D3D11		
-						if (pEffect->m_CS)
-						{
-							pDrawList->setDispatchParams(Vector3(numInstancesInGroup, 1, 1));
-							if (iEffect == 0)
-								addSAs_InstancedAnimationCSMap(pDrawList, pMeshInstance, pMeshCaller, numInstancesInGroup, iSrcInstanceInBoneSegment);
-							else
-								addSAs_InstancedAnimationCSReduce(pDrawList, pMeshInstance);
-						}
-						if (!pEffect->m_CS)
-						#endif
+						addNonInstancedTechShaderActions(
+							pMeshCaller, ir, iBoneSegment, iRenderGroup, iSrcInstanceInBoneSegment,
+							hasJointSegments, pDrawList, pEffect, evtProjectionViewWorldMatrix,
+							vbCount, vbWeights);
+					}
+					
+					if (haveInstancesAndInstanceEffect) // instanced
+					{
+						if (hasJointSegments)
 						{
-							// Final VS/PS pass
-							addSAa_InstancedAnimation_CSOnly_Pass2_and_CSCPU_Pass1_and_NoCS_Pass0(
-								pDrawList, pMeshCaller, evtProjectionViewWorldMatrix,
-								numInstancesInGroup, iSrcInstanceInBoneSegment);
-
-							if (iEffect == 2)
+							MeshInstance *pMeshInstance = pMeshCaller->getFirstComponent<MeshInstance>();
+							#if PE_API_IS_D3D11		
+							if (pEffect->m_CS)
 							{
-								addSAa_InstancedAnimation_CSOnly_Pass2(pDrawList);
+								pDrawList->setDispatchParams(Vector3(numInstancesInGroup, 1, 1));
+								if (iEffect == 0)
+									addSAs_InstancedAnimationCSMap(pDrawList, pMeshInstance, pMeshCaller, numInstancesInGroup, iSrcInstanceInBoneSegment);
+								else
+									addSAs_InstancedAnimationCSReduce(pDrawList, pMeshInstance);
 							}
-							else if (iEffect == 0)
+							if (!pEffect->m_CS)
+							#endif
 							{
-								addSAa_InstancedAnimation_NoCS_Pass0(
+								// Final VS/PS pass
+								addSAa_InstancedAnimation_CSOnly_Pass2_and_CSCPU_Pass1_and_NoCS_Pass0(
 									pDrawList, pMeshCaller, evtProjectionViewWorldMatrix,
 									numInstancesInGroup, iSrcInstanceInBoneSegment);
+
+								if (iEffect == 2)
+								{
+									addSAa_InstancedAnimation_CSOnly_Pass2(pDrawList);
+								}
+								else if (iEffect == 0)
+								{
+									addSAa_InstancedAnimation_NoCS_Pass0(
+										pDrawList, pMeshCaller, evtProjectionViewWorldMatrix,
+										numInstancesInGroup, iSrcInstanceInBoneSegment);
+								}
 							}
 						}
 					}
 				}
-			}
 
-			// Advance instance cursor (kept as in original flow).
-			iSrcInstance = iSrcInstanceInBoneSegment + 1;
+				// Next group starts after all instances submitted by this one.
+				iSrcInstance = skipInstancesInLodBucket(pMeshCaller, iSrcInstance, numInstancesInGroup, iLod, numLodBuckets);
+			}
 		}
 	}
 }
@@ -718,6 +847,7 @@ void SingleHandler_DRAW::addNonInstancedTechShaderActions(
 			DefaultAnimationSM *pAnimSM = pParentSkelInstance->getFirstComponent<DefaultAnimationSM>();
 			PEASSERT(pAnimSM->m_curPalette.m_size > 0 && pAnimSM->m_curPalette.m_size <= PE_MAX_BONE_COUNT_IN_DRAW_CALL,
 				"Invalid matrix palette size");
+			// gJoints are float4x4 in the skinning shaders, so the palette goes up as full matrices
 			memcpy(&pAnimPal->m_data.gJoints[0], &(pAnimSM->m_curPalette[0]),
 				sizeof(Matrix4x4) * pAnimSM->m_curPalette.m_size);
 		#else
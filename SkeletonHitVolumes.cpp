@@ -0,0 +1,403 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <float.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "SkeletonHitVolumes.h"
+#include "SkinJointBounds.h"
+
+namespace PE {
+namespace Components {
+
+static inline PrimitiveTypes::Float32 clamp01(PrimitiveTypes::Float32 x)
+{
+	return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x);
+}
+
+static inline PrimitiveTypes::Float32 axisValue(const Vector3 &v, int axis)
+{
+	return axis == 0 ? v.m_x : (axis == 1 ? v.m_y : v.m_z);
+}
+
+static void expandBox(Vector3 &mn, Vector3 &mx, const Vector3 &p, PrimitiveTypes::Float32 r)
+{
+	if (p.m_x - r < mn.m_x) mn.m_x = p.m_x - r;
+	if (p.m_y - r < mn.m_y) mn.m_y = p.m_y - r;
+	if (p.m_z - r < mn.m_z) mn.m_z = p.m_z - r;
+	if (p.m_x + r > mx.m_x) mx.m_x = p.m_x + r;
+	if (p.m_y + r > mx.m_y) mx.m_y = p.m_y + r;
+	if (p.m_z + r > mx.m_z) mx.m_z = p.m_z + r;
+}
+
+// slab test of segment from + t * dir, t in [0, 1]
+static bool segmentHitsBox(const Vector3 &from, const Vector3 &dir, const Vector3 &mn, const Vector3 &mx)
+{
+	PrimitiveTypes::Float32 tMin = 0.0f, tMax = 1.0f;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const PrimitiveTypes::Float32 o = axisValue(from, axis);
+		const PrimitiveTypes::Float32 d = axisValue(dir, axis);
+		const PrimitiveTypes::Float32 lo = axisValue(mn, axis);
+		const PrimitiveTypes::Float32 hi = axisValue(mx, axis);
+
+		if (fabsf(d) < 1e-8f)
+		{
+			if (o < lo || o > hi)
+				return false;
+			continue;
+		}
+
+		PrimitiveTypes::Float32 t0 = (lo - o) / d;
+		PrimitiveTypes::Float32 t1 = (hi - o) / d;
+		if (t0 > t1) { PrimitiveTypes::Float32 tmp = t0; t0 = t1; t1 = tmp; }
+		if (t0 > tMin) tMin = t0;
+		if (t1 < tMax) tMax = t1;
+		if (tMin > tMax)
+			return false;
+	}
+	return true;
+}
+
+static bool sphereHitsBox(const Vector3 &c, PrimitiveTypes::Float32 r, const Vector3 &mn, const Vector3 &mx)
+{
+	PrimitiveTypes::Float32 distSqr = 0.0f;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const PrimitiveTypes::Float32 v = axisValue(c, axis);
+		const PrimitiveTypes::Float32 lo = axisValue(mn, axis);
+		const PrimitiveTypes::Float32 hi = axisValue(mx, axis);
+		if (v < lo) distSqr += (lo - v) * (lo - v);
+		else if (v > hi) distSqr += (v - hi) * (v - hi);
+	}
+	return distSqr <= r * r;
+}
+
+// squared distance between segments p1-q1 and p2-q2; s is the parameter on the first one
+static PrimitiveTypes::Float32 segmentSegmentDistSqr(const Vector3 &p1, const Vector3 &q1, const Vector3 &p2, const Vector3 &q2,
+	PrimitiveTypes::Float32 &s)
+{
+	const Vector3 d1 = q1 - p1;
+	const Vector3 d2 = q2 - p2;
+	const Vector3 r = p1 - p2;
+	const PrimitiveTypes::Float32 a = d1.dotProduct(d1);
+	const PrimitiveTypes::Float32 e = d2.dotProduct(d2);
+	const PrimitiveTypes::Float32 f = d2.dotProduct(r);
+	PrimitiveTypes::Float32 t;
+
+	if (a <= 1e-8f && e <= 1e-8f)
+	{
+		s = 0.0f;
+		return r.dotProduct(r);
+	}
+
+	if (a <= 1e-8f)
+	{
+		s = 0.0f;
+		t = clamp01(f / e);
+	}
+	else
+	{
+		const PrimitiveTypes::Float32 c = d1.dotProduct(r);
+		if (e <= 1e-8f)
+		{
+			t = 0.0f;
+			s = clamp01(-c / a);
+		}
+		else
+		{
+			const PrimitiveTypes::Float32 b = d1.dotProduct(d2);
+			const PrimitiveTypes::Float32 denom = a * e - b * b;
+			s = denom > 1e-8f ? clamp01((b * f - c * e) / denom) : 0.0f;
+			t = (b * s + f) / e;
+			if (t < 0.0f)
+			{
+				t = 0.0f;
+				s = clamp01(-c / a);
+			}
+			else if (t > 1.0f)
+			{
+				t = 1.0f;
+				s = clamp01((b - c) / a);
+			}
+		}
+	}
+
+	const Vector3 diff = (p1 + d1 * s) - (p2 + d2 * t);
+	return diff.dotProduct(diff);
+}
+
+// smallest t in [0, 1] at which from + t * dir is inside the sphere
+static bool segmentSphereEntry(const Vector3 &from, const Vector3 &dir, const Vector3 &center, PrimitiveTypes::Float32 radius,
+	PrimitiveTypes::Float32 &t)
+{
+	const Vector3 m = from - center;
+	const PrimitiveTypes::Float32 a = dir.dotProduct(dir);
+	const PrimitiveTypes::Float32 b = m.dotProduct(dir);
+	const PrimitiveTypes::Float32 c = m.dotProduct(m) - radius * radius;
+	if (c <= 0.0f)
+	{
+		t = 0.0f;
+		return true;
+	}
+	if (b >= 0.0f || a <= 1e-8f)
+		return false;
+
+	const PrimitiveTypes::Float32 disc = b * b - a * c;
+	if (disc < 0.0f)
+		return false;
+	t = (-b - sqrtf(disc)) / a;
+	return t <= 1.0f;
+}
+
+// smallest t in [0, 1] at which from + t * dir is inside the capsule.
+// The capsule is the union of the two end spheres and the side of the cylinder between them,
+// so the entry is the earliest entry into any of the three (entering through a flat cylinder end is inside a sphere)
+static bool segmentCapsuleEntry(const Vector3 &from, const Vector3 &dir, const SkeletonHitVolumes::Capsule &cap,
+	PrimitiveTypes::Float32 &t)
+{
+	bool hit = false;
+	t = FLT_MAX;
+
+	PrimitiveTypes::Float32 sphereT;
+	if (segmentSphereEntry(from, dir, cap.m_a, cap.m_radius, sphereT) && sphereT < t) { t = sphereT; hit = true; }
+	if (segmentSphereEntry(from, dir, cap.m_b, cap.m_radius, sphereT) && sphereT < t) { t = sphereT; hit = true; }
+
+	// side: |m + t n|^2 - (m.d + t n.d)^2 / d.d = r^2, taking the first root where the axial position is between the ends
+	const Vector3 d = cap.m_b - cap.m_a;
+	const Vector3 m = from - cap.m_a;
+	const PrimitiveTypes::Float32 dd = d.dotProduct(d);
+	const PrimitiveTypes::Float32 md = m.dotProduct(d);
+	const PrimitiveTypes::Float32 nd = dir.dotProduct(d);
+	const PrimitiveTypes::Float32 a = dd * dir.dotProduct(dir) - nd * nd;
+	if (dd > 1e-8f && a > 1e-8f)
+	{
+		const PrimitiveTypes::Float32 b = dd * m.dotProduct(dir) - nd * md;
+		const PrimitiveTypes::Float32 c = dd * (m.dotProduct(m) - cap.m_radius * cap.m_radius) - md * md;
+		const PrimitiveTypes::Float32 disc = b * b - a * c;
+		if (disc >= 0.0f)
+		{
+			PrimitiveTypes::Float32 sideT = (-b - sqrtf(disc)) / a;
+			if (c <= 0.0f)
+				sideT = 0.0f; // starts inside the infinite cylinder
+			const PrimitiveTypes::Float32 axial = md + sideT * nd;
+			if (sideT >= 0.0f && sideT <= 1.0f && axial >= 0.0f && axial <= dd && sideT < t)
+			{
+				t = sideT;
+				hit = true;
+			}
+		}
+	}
+	return hit;
+}
+
+SkeletonHitVolumes::SkeletonHitVolumes(PE::GameContext &context, PE::MemoryArena arena)
+: m_jointMin(context, arena)
+, m_jointMax(context, arena)
+, m_localCapsules(context, arena)
+, m_capsules(context, arena)
+{
+	// empty until the first update
+	for (int r = 0; r < PE_SKELETON_HIT_SLICE_COUNT; ++r)
+	{
+		m_sliceMin[r] = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+		m_sliceMax[r] = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	}
+	for (int r = 0; r <= PE_SKELETON_HIT_SLICE_COUNT; ++r)
+		m_sliceFirstJoint[r] = 0;
+	m_bodyMin = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+	m_bodyMax = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	m_worldToModelScale = 1.0f;
+}
+
+void SkeletonHitVolumes::addJointBoxes(const SkinJointBounds &bounds)
+{
+	const int numJoints = bounds.m_jointMin.m_size;
+
+	if (m_jointMin.m_size == 0)
+	{
+		m_jointMin.reset(numJoints);
+		m_jointMax.reset(numJoints);
+		m_jointMin.m_size = m_jointMax.m_size = numJoints;
+		for (int j = 0; j < numJoints; ++j)
+		{
+			m_jointMin[j] = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+			m_jointMax[j] = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		}
+	}
+	PEASSERT(numJoints <= (int)(m_jointMin.m_size), "All skinned meshes of a skeleton are expected to use the first mesh's joint range");
+
+	for (int i = 0; i < bounds.m_usedJoints.m_size; ++i)
+	{
+		const int j = bounds.m_usedJoints[i];
+		if (j >= (int)(m_jointMin.m_size))
+			continue;
+		expandBox(m_jointMin[j], m_jointMax[j], bounds.m_jointMin[j], 0.0f);
+		expandBox(m_jointMin[j], m_jointMax[j], bounds.m_jointMax[j], 0.0f);
+	}
+
+	// one capsule per joint along the longest axis of its box; radius covers the other two axes
+	const int numCapsules = m_jointMin.m_size;
+	m_localCapsules.reset(numCapsules);
+	m_capsules.reset(numCapsules);
+	m_localCapsules.m_size = m_capsules.m_size = numCapsules;
+
+	for (int j = 0; j < numCapsules; ++j)
+	{
+		Capsule &cap = m_localCapsules[j];
+		if (m_jointMin[j].m_x > m_jointMax[j].m_x)
+		{
+			cap.m_a = cap.m_b = Vector3(0, 0, 0);
+			cap.m_radius = 0.0f;
+			continue;
+		}
+
+		const Vector3 center = (m_jointMin[j] + m_jointMax[j]) * 0.5f;
+		const Vector3 half = (m_jointMax[j] - m_jointMin[j]) * 0.5f;
+
+		int axis = 0;
+		if (half.m_y > axisValue(half, axis)) axis = 1;
+		if (half.m_z > axisValue(half, axis)) axis = 2;
+
+		// the radius reaches the corners of the box cross-section and the segment runs to the end faces,
+		// so the capsule contains the whole box
+		const PrimitiveTypes::Float32 h0 = axisValue(half, (axis + 1) % 3);
+		const PrimitiveTypes::Float32 h1 = axisValue(half, (axis + 2) % 3);
+		cap.m_radius = sqrtf(h0 * h0 + h1 * h1);
+		if (cap.m_radius < 1e-4f)
+			cap.m_radius = 1e-4f;
+
+		const PrimitiveTypes::Float32 segHalf = axisValue(half, axis);
+
+		Vector3 offset(0, 0, 0);
+		if (axis == 0) offset.m_x = segHalf;
+		else if (axis == 1) offset.m_y = segHalf;
+		else offset.m_z = segHalf;
+
+		cap.m_a = center - offset;
+		cap.m_b = center + offset;
+	}
+
+	for (int r = 0; r <= PE_SKELETON_HIT_SLICE_COUNT; ++r)
+		m_sliceFirstJoint[r] = r * numCapsules / PE_SKELETON_HIT_SLICE_COUNT;
+}
+
+void SkeletonHitVolumes::update(const Matrix4x4 &world, const Matrix4x4 *pSkinPalette, int numPaletteJoints)
+{
+	m_bodyMin = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+	m_bodyMax = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+	// slice and body boxes stay in model space; placed by the world matrix they are oriented boxes
+	Matrix4x4 worldCopy = world;
+	m_worldToModel = worldCopy.inverse();
+	const PrimitiveTypes::Float32 worldScale = world.getU().length();
+	m_worldToModelScale = worldScale > 1e-8f ? 1.0f / worldScale : 0.0f;
+
+	for (int r = 0; r < PE_SKELETON_HIT_SLICE_COUNT; ++r)
+	{
+		Vector3 &mn = m_sliceMin[r];
+		Vector3 &mx = m_sliceMax[r];
+		mn = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+		mx = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+		for (int j = m_sliceFirstJoint[r]; j < m_sliceFirstJoint[r + 1]; ++j)
+		{
+			const Capsule &local = m_localCapsules[j];
+			Capsule &cap = m_capsules[j];
+			if (local.m_radius == 0.0f || j >= numPaletteJoints)
+			{
+				cap.m_radius = 0.0f;
+				continue;
+			}
+
+			const Matrix4x4 &m = pSkinPalette[j];
+			const Vector3 a = m * local.m_a;
+			const Vector3 b = m * local.m_b;
+			const PrimitiveTypes::Float32 radius = local.m_radius * m.getU().length(); // palettes carry a uniform skin scale
+
+			expandBox(mn, mx, a, radius);
+			expandBox(mn, mx, b, radius);
+
+			cap.m_a = world * a;
+			cap.m_b = world * b;
+			cap.m_radius = radius * worldScale;
+		}
+
+		if (mn.m_x <= mx.m_x)
+		{
+			expandBox(m_bodyMin, m_bodyMax, mn, 0.0f);
+			expandBox(m_bodyMin, m_bodyMax, mx, 0.0f);
+		}
+	}
+}
+
+int SkeletonHitVolumes::raycast(const Vector3 &from, const Vector3 &to, PrimitiveTypes::Float32 *pOutT) const
+{
+	// boxes are tested in model space; segment parameters are the same in both spaces
+	const Vector3 modelFrom = m_worldToModel * from;
+	const Vector3 modelDir = m_worldToModel * to - modelFrom;
+	if (!segmentHitsBox(modelFrom, modelDir, m_bodyMin, m_bodyMax))
+		return -1;
+
+	int hitJoint = -1;
+	PrimitiveTypes::Float32 hitT = FLT_MAX;
+
+	for (int r = 0; r < PE_SKELETON_HIT_SLICE_COUNT; ++r)
+	{
+		if (m_sliceMin[r].m_x > m_sliceMax[r].m_x || !segmentHitsBox(modelFrom, modelDir, m_sliceMin[r], m_sliceMax[r]))
+			continue;
+
+		for (int j = m_sliceFirstJoint[r]; j < m_sliceFirstJoint[r + 1]; ++j)
+		{
+			const Capsule &cap = m_capsules[j];
+			if (cap.m_radius == 0.0f)
+				continue;
+
+			PrimitiveTypes::Float32 t;
+			if (segmentCapsuleEntry(from, to - from, cap, t) && t < hitT)
+			{
+				hitT = t;
+				hitJoint = j;
+			}
+		}
+	}
+
+	if (pOutT && hitJoint >= 0)
+		*pOutT = hitT;
+	return hitJoint;
+}
+
+int SkeletonHitVolumes::overlapSphere(const Vector3 &center, PrimitiveTypes::Float32 radius) const
+{
+	const Vector3 modelCenter = m_worldToModel * center;
+	const PrimitiveTypes::Float32 modelRadius = radius * m_worldToModelScale;
+	if (!sphereHitsBox(modelCenter, modelRadius, m_bodyMin, m_bodyMax))
+		return -1;
+
+	for (int r = 0; r < PE_SKELETON_HIT_SLICE_COUNT; ++r)
+	{
+		if (m_sliceMin[r].m_x > m_sliceMax[r].m_x || !sphereHitsBox(modelCenter, modelRadius, m_sliceMin[r], m_sliceMax[r]))
+			continue;
+
+		for (int j = m_sliceFirstJoint[r]; j < m_sliceFirstJoint[r + 1]; ++j)
+		{
+			const Capsule &cap = m_capsules[j];
+			if (cap.m_radius == 0.0f)
+				continue;
+
+			PrimitiveTypes::Float32 s;
+			const PrimitiveTypes::Float32 reach = cap.m_radius + radius;
+			if (segmentSegmentDistSqr(center, center, cap.m_a, cap.m_b, s) <= reach * reach)
+				return j;
+		}
+	}
+	return -1;
+}
+
+}; // namespace Components
+}; // namespace PE
@@ -0,0 +1,75 @@
+#ifndef __PYENGINE_2_0_SKELETON_HIT_VOLUMES_H__
+#define __PYENGINE_2_0_SKELETON_HIT_VOLUMES_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Math/Vector3.h"
+
+// Sibling/Children includes
+
+// joints are split into this many equal slices of consecutive indices. Slices follow the joint order of the
+// skeleton file, not its hierarchy, so one slice can span several limbs
+#define PE_SKELETON_HIT_SLICE_COUNT 6
+
+namespace PE {
+namespace Components {
+
+struct SkinJointBounds;
+
+// Per-bone capsules for precise hit queries on animated characters.
+// Queries go body OBB -> slice OBBs -> capsules of the slices that overlap,
+// so a miss costs one box test and a hit only tests the bones near it.
+// Body and slice boxes are kept in model space and queries are moved into it once.
+struct SkeletonHitVolumes
+{
+	struct Capsule
+	{
+		Vector3 m_a;
+		Vector3 m_b;
+		PrimitiveTypes::Float32 m_radius;
+	};
+
+	SkeletonHitVolumes(PE::GameContext &context, PE::MemoryArena arena);
+
+	// Adds the per joint bind pose boxes of one skinned mesh; capsules are rebuilt from the union of all added meshes
+	void addJointBoxes(const SkinJointBounds &bounds);
+	bool isBuilt() const { return m_localCapsules.m_size > 0; }
+
+	// Places capsules for the current pose. pSkinPalette has bind inverses applied
+	void update(const Matrix4x4 &world, const Matrix4x4 *pSkinPalette, int numPaletteJoints);
+
+	// Segment query; returns the joint whose capsule the segment enters first, or -1.
+	// pOutT is the entry parameter along from -> to (0 when from is inside a capsule)
+	int raycast(const Vector3 &from, const Vector3 &to, PrimitiveTypes::Float32 *pOutT = NULL) const;
+
+	// Sphere overlap; returns the first overlapping joint or -1
+	int overlapSphere(const Vector3 &center, PrimitiveTypes::Float32 radius) const;
+
+	// Data --------------------------------------------------------------------
+	Array<Vector3> m_jointMin; // merged bind pose boxes
+	Array<Vector3> m_jointMax;
+	Array<Capsule> m_localCapsules; // bind pose capsules, indexed by joint (radius 0 = joint has no vertices)
+	Array<Capsule> m_capsules;      // current pose, world space
+
+	Vector3 m_sliceMin[PE_SKELETON_HIT_SLICE_COUNT]; // model space
+	Vector3 m_sliceMax[PE_SKELETON_HIT_SLICE_COUNT];
+	int m_sliceFirstJoint[PE_SKELETON_HIT_SLICE_COUNT + 1];
+	Vector3 m_bodyMin; // model space
+	Vector3 m_bodyMax;
+	Matrix4x4 m_worldToModel; // inverse of the world matrix of the last update()
+	PrimitiveTypes::Float32 m_worldToModelScale;
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
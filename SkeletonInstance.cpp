@@ -29,6 +29,7 @@
 #include "PrimeEngine/Events/StandardEvents.h"
 
 #include "CharacterControl/PhysicsManager.h"
+#include "SkeletonHitVolumes.h"
 
 namespace PE {
 namespace Components{
@@ -40,6 +41,11 @@ SkeletonInstance::SkeletonInstance(PE::GameContext &context, PE::MemoryArena are
 : Component(context, arena, hMyself)
 , m_hAnimationSM(hDefaultStateMachine)
 , m_hAnimationSetGPUs(context, arena, 8)
+, m_hasPoseBounds(false)
+, m_paletteIsBindPose(false)
+, m_skeletonAssetHash(0)
+, m_animLod(context, arena)
+, m_poseCacheable(false)
 {
 }
 
@@ -47,6 +53,7 @@ void SkeletonInstance::initFromFiles(const char *skeletonAssetName, const char *
 	int &threadOwnershipMask)
 {
 	Handle h = m_pContext->getMeshManager()->getAsset(skeletonAssetName, skeletonAssetPackage, threadOwnershipMask);
+	m_skeletonAssetHash = AssetId::Hash(skeletonAssetName, skeletonAssetPackage);
 
 	static int allowedEvts[] = {0};
 	// note we don't want to receive any events from this parent so we don't allow our event handlers to propagate to this parent
@@ -57,6 +64,18 @@ void SkeletonInstance::initFromFiles(const char *skeletonAssetName, const char *
 	createPhysicsManager();
 }
 
+void SkeletonInstance::initFromFiles(const AssetId &skeletonId, int &threadOwnershipMask)
+{
+	Handle h = AssetHashTable::Instance() ? AssetHashTable::Instance()->findOrLoad(skeletonId, threadOwnershipMask)
+		: m_pContext->getMeshManager()->getAsset(skeletonId.m_asset, skeletonId.m_package, threadOwnershipMask);
+	m_skeletonAssetHash = skeletonId.m_hash;
+
+	static int allowedEvts[] = {0};
+	h.getObject<Component>()->addComponent(m_hMyself, &allowedEvts[0]);
+
+	createPhysicsManager();
+}
+
 void SkeletonInstance::setAnimSet(const char *animsetAssetName, const char *animsetAssetPackage)
 {
 	Skeleton *pSkel = getFirstParentByTypePtr<Skeleton>();
@@ -71,10 +90,17 @@ void SkeletonInstance::createPhysicsManager()
 	PhysicsManager *pPhyManager = new(hPhyManager) PhysicsManager(*m_pContext, m_arena, hPhyManager);
 	pPhyManager->addDefaultComponents();
 
-	// Joint AABBs are updated from DefaultAnimationSM.cpp during the debug/update pass.
+	// Pose bounds are updated from DefaultAnimationSM.cpp with the animation palette.
 	addComponent(hPhyManager);
 }
 
+void SkeletonInstance::createHitVolumes()
+{
+	// Capsules are shaped from the skinned meshes' joint boxes on the first palette update.
+	m_hHitVolumes = PE::Handle("SkeletonHitVolumes", sizeof(SkeletonHitVolumes));
+	new(m_hHitVolumes) SkeletonHitVolumes(*m_pContext, m_arena);
+}
+
 void SkeletonInstance::addDefaultComponents()
 {
 	if (m_hAnimationSM.isValid())
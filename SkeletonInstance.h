@@ -13,6 +13,9 @@
 
 // Sibling/Children includes
 #include "Mesh.h"
+#include "AnimationLod.h"
+#include "PoseCache.h"
+#include "AssetHashTable.h"
 
 namespace PE {
 namespace Components {
@@ -31,10 +34,29 @@ struct SkeletonInstance : public Component
 
 	void createPhysicsManager();
 
+	// Optional per-bone capsules for precise hit queries (SkeletonHitVolumes), updated with the palette
+	void createHitVolumes();
+
 	void initFromFiles(const char *skeletonAssetName, const char *skeletonAssetPackage, int &threadOwnershipMask);
+	void initFromFiles(const AssetId &skeletonId, int &threadOwnershipMask); // hashed name, for spawn paths
 	void setAnimSet(const char *animsetAssetName, const char *animsetAssetPackage);
 	Array<Handle> m_hAnimationSetGPUs;
 	Handle m_hAnimationSM;
+
+	// Model space bounds of the current pose, updated with the animation palette
+	Vector3 m_poseBoundsMin;
+	Vector3 m_poseBoundsMax;
+	bool m_hasPoseBounds;
+	bool m_paletteIsBindPose; // palettes hold the Skeleton's bind pose; nothing to evaluate while idle
+	PrimitiveTypes::UInt64 m_skeletonAssetHash; // AssetId hash of the Skeleton, key of its BindPoseCache entry
+
+	Handle m_hHitVolumes; // invalid unless createHitVolumes() was called
+
+	AnimationLodState m_animLod; // update rate of the animation palette, fed by culling
+
+	// pose of this frame's evaluation in the shared PoseCache, built with the job
+	PoseCacheKey m_poseCacheKey;
+	bool m_poseCacheable;
 };
 
 }; // namespace Components
@@ -0,0 +1,137 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <float.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Geometry/MeshCPU/MeshCPU.h"
+
+// Sibling/Children includes
+#include "SkinJointBounds.h"
+#include "PoseBounds.h"
+
+namespace PE {
+namespace Components {
+
+SkinJointBounds::SkinJointBounds(PE::GameContext &context, PE::MemoryArena arena)
+: m_jointMin(context, arena)
+, m_jointMax(context, arena)
+, m_usedJoints(context, arena)
+{
+}
+
+void SkinJointBounds::build(PositionBufferCPU *pPositions, SkinWeightsCPU *pWeights)
+{
+	const int numVertices = pPositions->m_values.m_size / 3;
+	PEASSERT(numVertices <= (int)(pWeights->m_weightsPerVertex.m_size), "Skin weights do not cover the position buffer");
+
+	int numJoints = 0;
+	for (int i = 0; i < numVertices; ++i)
+	{
+		Array<WeightPair> &weights = pWeights->m_weightsPerVertex[i];
+		for (int iw = 0; iw < weights.m_size; ++iw)
+		{
+			if ((int)(weights[iw].m_jointIndex) + 1 > numJoints)
+				numJoints = weights[iw].m_jointIndex + 1;
+		}
+	}
+
+	m_jointMin.reset(numJoints);
+	m_jointMax.reset(numJoints);
+	m_jointMin.m_size = m_jointMax.m_size = numJoints;
+	for (int j = 0; j < numJoints; ++j)
+	{
+		m_jointMin[j] = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+		m_jointMax[j] = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	}
+
+	for (int i = 0; i < numVertices; ++i)
+	{
+		const Vector3 pos(pPositions->m_values[i * 3], pPositions->m_values[i * 3 + 1], pPositions->m_values[i * 3 + 2]);
+
+		Array<WeightPair> &weights = pWeights->m_weightsPerVertex[i];
+		for (int iw = 0; iw < weights.m_size; ++iw)
+		{
+			// any influence counts, otherwise the box is not conservative
+			if (weights[iw].m_weight <= 0.0f)
+				continue;
+
+			Vector3 &mn = m_jointMin[weights[iw].m_jointIndex];
+			Vector3 &mx = m_jointMax[weights[iw].m_jointIndex];
+			if (pos.m_x < mn.m_x) mn.m_x = pos.m_x;
+			if (pos.m_y < mn.m_y) mn.m_y = pos.m_y;
+			if (pos.m_z < mn.m_z) mn.m_z = pos.m_z;
+			if (pos.m_x > mx.m_x) mx.m_x = pos.m_x;
+			if (pos.m_y > mx.m_y) mx.m_y = pos.m_y;
+			if (pos.m_z > mx.m_z) mx.m_z = pos.m_z;
+		}
+	}
+
+	collectUsedJoints();
+}
+
+void SkinJointBounds::initFromBoxes(const PrimitiveTypes::Float32 *pBoxes, int numJoints)
+{
+	m_jointMin.reset(numJoints);
+	m_jointMax.reset(numJoints);
+	m_jointMin.m_size = m_jointMax.m_size = numJoints;
+	for (int j = 0; j < numJoints; ++j)
+	{
+		const PrimitiveTypes::Float32 *b = &pBoxes[j * 6];
+		m_jointMin[j] = Vector3(b[0], b[1], b[2]);
+		m_jointMax[j] = Vector3(b[3], b[4], b[5]);
+	}
+
+	collectUsedJoints();
+}
+
+void SkinJointBounds::collectUsedJoints()
+{
+	const int numJoints = m_jointMin.m_size;
+	int numUsed = 0;
+	for (int j = 0; j < numJoints; ++j)
+		if (m_jointMin[j].m_x <= m_jointMax[j].m_x)
+			++numUsed;
+
+	m_usedJoints.reset(numUsed);
+	for (int j = 0; j < numJoints; ++j)
+		if (m_jointMin[j].m_x <= m_jointMax[j].m_x)
+			m_usedJoints.add((PrimitiveTypes::UInt16)(j));
+}
+
+bool SkinJointBounds::computePoseBounds(const Matrix4x4 *pSkinPalette, int numPaletteJoints, Vector3 &outMin, Vector3 &outMax) const
+{
+	bool haveBounds = false;
+
+	for (int i = 0; i < m_usedJoints.m_size; ++i)
+	{
+		const int j = m_usedJoints[i];
+		if (j >= numPaletteJoints)
+			continue;
+
+		Vector3 mn, mx;
+		PoseBounds::transformBounds(pSkinPalette[j], m_jointMin[j], m_jointMax[j], mn, mx);
+
+		if (!haveBounds)
+		{
+			outMin = mn;
+			outMax = mx;
+			haveBounds = true;
+			continue;
+		}
+
+		if (mn.m_x < outMin.m_x) outMin.m_x = mn.m_x;
+		if (mn.m_y < outMin.m_y) outMin.m_y = mn.m_y;
+		if (mn.m_z < outMin.m_z) outMin.m_z = mn.m_z;
+		if (mx.m_x > outMax.m_x) outMax.m_x = mx.m_x;
+		if (mx.m_y > outMax.m_y) outMax.m_y = mx.m_y;
+		if (mx.m_z > outMax.m_z) outMax.m_z = mx.m_z;
+	}
+
+	return haveBounds;
+}
+
+}; // namespace Components
+}; // namespace PE
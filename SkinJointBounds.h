@@ -0,0 +1,52 @@
+#ifndef __PYENGINE_2_0_SKIN_JOINT_BOUNDS_H__
+#define __PYENGINE_2_0_SKIN_JOINT_BOUNDS_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Math/Vector3.h"
+
+// Sibling/Children includes
+
+namespace PE {
+struct PositionBufferCPU;
+struct SkinWeightsCPU;
+namespace Components {
+
+// Bind pose box, per joint, of the vertices the joint influences. Built once per skinned Mesh at load.
+// A skinned vertex is a weighted blend of its joints' transforms of the bind pose position, so it always lies
+// inside the union of its joints' boxes moved by the skinning palette. This gives conservative bounds
+// for O(joints) work per frame and no per-vertex work.
+struct SkinJointBounds
+{
+	SkinJointBounds(PE::GameContext &context, PE::MemoryArena arena);
+
+	void build(PositionBufferCPU *pPositions, SkinWeightsCPU *pWeights);
+
+	// Same boxes from baked data (CollisionSidecar): 6 floats per joint, min > max for unused joints
+	void initFromBoxes(const PrimitiveTypes::Float32 *pBoxes, int numJoints);
+
+	// Model space box of the skinned mesh. pSkinPalette is the palette with bind inverses applied
+	// (DefaultAnimationSM::m_curPalette). Returns false if no joint influences any vertex
+	bool computePoseBounds(const Matrix4x4 *pSkinPalette, int numPaletteJoints, Vector3 &outMin, Vector3 &outMax) const;
+
+	void collectUsedJoints();
+
+	// Data --------------------------------------------------------------------
+	Array<Vector3> m_jointMin; // bind pose (mesh space) boxes, indexed by joint
+	Array<Vector3> m_jointMax;
+	Array<PrimitiveTypes::UInt16> m_usedJoints; // joints that influence at least one vertex
+};
+
+}; // namespace Components
+}; // namespace PE
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef __PYENGINE_2_0_SLAB_POOL_H__
+#define __PYENGINE_2_0_SLAB_POOL_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <new>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+
+// Sibling/Children includes
+
+#define PE_SLAB_POOL_CACHE_LINE 64
+
+namespace PE {
+
+// Fixed size objects of one type in slabs of ItemsPerSlab, outside the arena.
+// Freed items go on a free list and are reused first; slabs are only released with the pool.
+// Slabs start on a cache line and items of a cache line or more are padded to whole lines,
+// smaller ones to a power of two, so no item straddles a line it does not have to.
+// Not thread safe: used where components are created, on the game thread.
+template <typename T, int ItemsPerSlab = 64>
+struct SlabPool
+{
+	SlabPool()
+	: m_pFreeList(NULL)
+	, m_pSlabs(NULL)
+	, m_numSlabs(0)
+	, m_numLive(0)
+	{
+	}
+
+	~SlabPool()
+	{
+		while (m_pSlabs)
+		{
+			SlabHeader *pNext = m_pSlabs->m_pNext;
+			::free(m_pSlabs->m_pRaw);
+			m_pSlabs = pNext;
+		}
+	}
+
+	// Storage for one T; construct with placement new and return it with destroy()
+	void *allocate()
+	{
+		if (!m_pFreeList)
+			addSlab();
+
+		FreeItem *pItem = m_pFreeList;
+		m_pFreeList = pItem->m_pNext;
+		++m_numLive;
+		return pItem;
+	}
+
+	void destroy(T *p)
+	{
+		if (!p)
+			return;
+		p->~T();
+
+		FreeItem *pItem = (FreeItem *)(p);
+		pItem->m_pNext = m_pFreeList;
+		m_pFreeList = pItem;
+		--m_numLive;
+	}
+
+	int getNumLive() const { return m_numLive; }
+	int getNumSlabs() const { return m_numSlabs; }
+
+private:
+	struct FreeItem
+	{
+		FreeItem *m_pNext;
+	};
+
+	// first cache line of every slab
+	struct SlabHeader
+	{
+		SlabHeader *m_pNext;
+		void *m_pRaw; // as returned by malloc
+	};
+
+	static size_t itemStride()
+	{
+		size_t size = sizeof(T) < sizeof(FreeItem) ? sizeof(FreeItem) : sizeof(T);
+		if (size >= PE_SLAB_POOL_CACHE_LINE)
+			return (size + PE_SLAB_POOL_CACHE_LINE - 1) & ~(size_t)(PE_SLAB_POOL_CACHE_LINE - 1);
+
+		size_t stride = sizeof(void *);
+		while (stride < size)
+			stride <<= 1;
+		return stride;
+	}
+
+	void addSlab()
+	{
+		const size_t stride = itemStride();
+		const size_t bytes = PE_SLAB_POOL_CACHE_LINE + stride * ItemsPerSlab;
+		void *pRaw = ::malloc(bytes + PE_SLAB_POOL_CACHE_LINE - 1);
+		PEASSERT(pRaw, "Slab allocation failed");
+
+		char *pBase = (char *)(((uintptr_t)(pRaw) + PE_SLAB_POOL_CACHE_LINE - 1) & ~(uintptr_t)(PE_SLAB_POOL_CACHE_LINE - 1));
+		SlabHeader *pHeader = (SlabHeader *)(pBase);
+		pHeader->m_pNext = m_pSlabs;
+		pHeader->m_pRaw = pRaw;
+		m_pSlabs = pHeader;
+		++m_numSlabs;
+
+		// in address order, so consecutive allocations are adjacent
+		char *pItems = pBase + PE_SLAB_POOL_CACHE_LINE;
+		for (int i = ItemsPerSlab - 1; i >= 0; --i)
+		{
+			FreeItem *pItem = (FreeItem *)(pItems + stride * i);
+			pItem->m_pNext = m_pFreeList;
+			m_pFreeList = pItem;
+		}
+	}
+
+	SlabPool(const SlabPool &);
+	SlabPool &operator=(const SlabPool &);
+
+	FreeItem *m_pFreeList;
+	SlabHeader *m_pSlabs;
+	int m_numSlabs;
+	int m_numLive;
+};
+
+}; // namespace PE
+
+#endif
@@ -117,15 +117,20 @@ SoldierNPC::SoldierNPC(PE::GameContext &context, PE::MemoryArena arena, PE::Hand
 			hSoldierAnimSM);
 		pSkelInst->addDefaultComponents();
 
-		pSkelInst->initFromFiles("soldier_Soldier_Skeleton.skela", "Soldier", pEvt->m_threadOwnershipMask);
+		static const AssetId s_skeletonId("soldier_Soldier_Skeleton.skela", "Soldier");
+		pSkelInst->initFromFiles(s_skeletonId, pEvt->m_threadOwnershipMask);
 
 		pSkelInst->setAnimSet("soldier_Soldier_Skeleton.animseta", "Soldier");
 
+		// per-bone capsules for line of sight and projectile hits
+		pSkelInst->createHitVolumes();
+
 		PE::Handle hMeshInstance("MeshInstance", sizeof(MeshInstance));
 		MeshInstance *pMeshInstance = new(hMeshInstance) MeshInstance(*m_pContext, m_arena, hMeshInstance);
 		pMeshInstance->addDefaultComponents();
 		
-		pMeshInstance->initFromFile(pEvt->m_meshFilename, pEvt->m_package, pEvt->m_threadOwnershipMask);
+		// loaded off this thread; the instance is bound to its mesh when the upload is done
+		pMeshInstance->initFromFileAsync(AssetId(pEvt->m_meshFilename, pEvt->m_package), pEvt->m_threadOwnershipMask);
 		
 		pSkelInst->addComponent(hMeshInstance);
 
@@ -138,7 +143,7 @@ SoldierNPC::SoldierNPC(PE::GameContext &context, PE::MemoryArena arena, PE::Hand
 			MeshInstance *pGunMeshInstance = new(hMyGunMesh) MeshInstance(*m_pContext, m_arena, hMyGunMesh);
 
 			pGunMeshInstance->addDefaultComponents();
-			pGunMeshInstance->initFromFile(pEvt->m_gunMeshName, pEvt->m_gunMeshPackage, pEvt->m_threadOwnershipMask);
+			pGunMeshInstance->initFromFileAsync(AssetId(pEvt->m_gunMeshName, pEvt->m_gunMeshPackage), pEvt->m_threadOwnershipMask);
 
 			// create a scene node for gun attached to a joint
 
@@ -73,14 +73,10 @@ void SoldierNPCMovementSM::do_SoldierNPCMovementSM_Event_MOVE_TO(PE::Events::Eve
 
 	// make sure the animations are playing
 	
-	PE::Handle h("SoldierNPCAnimSM_Event_WALK", sizeof(SoldierNPCAnimSM_Event_WALK));
-	Events::SoldierNPCAnimSM_Event_WALK *pOutEvt = new(h) SoldierNPCAnimSM_Event_WALK();
+	Events::SoldierNPCAnimSM_Event_WALK Evt;
 	
 	SoldierNPC *pSol = getFirstParentByTypePtr<SoldierNPC>();
-	pSol->getFirstComponent<PE::Components::SceneNode>()->handleEvent(pOutEvt);
-
-	// release memory now that event is processed
-	h.release();
+	pSol->getFirstComponent<PE::Components::SceneNode>()->handleEvent(&Evt);
 }
 
 void SoldierNPCMovementSM::do_SoldierNPCMovementSM_Event_STOP(PE::Events::Event *pEvt)
@@ -103,11 +99,12 @@ void SoldierNPCMovementSM::do_UPDATE(PE::Events::Event *pEvt)
 			SceneNode *pRotateSN = ptempSN->getFirstComponent<SceneNode>();
 			SkeletonInstance *pSI = pRotateSN->getFirstComponent<SkeletonInstance>();
 			PhysicsManager *pPM = pSI->getFirstComponent<PhysicsManager>();
+			CharacterControllerState &controller = pPM->getController();
 
 			Vector3 dir;
 			Vector3 curPos = pSN->m_base.getPos();
 
-			if (!pPM->m_backward && pPM->m_collisionCount > 1)
+			if (!controller.m_backward && pPM->m_collisionCount > 1)
 			{
 				// Typical case is a single ground contact; if we detect an additional obstacle, steer along its surface
 				for (int i = 0; i < pPM->m_collisionPlane.m_size; ++i)
@@ -116,46 +113,46 @@ void SoldierNPCMovementSM::do_UPDATE(PE::Events::Event *pEvt)
 					if (pPM->m_collisionPlane[i].a == 0 && pPM->m_collisionPlane[i].c == 0) continue;
 
 					Vector3 vTargetToCus = m_targetPostion - pSN->m_base.getPos();
-					int checkCurCollisionPlaneExist = pPM->m_collisionPlane.indexOf(pPM->m_curCollisionPlane);
+					bool checkCurCollisionPlaneExist = pPM->hasCollisionPlane(controller.m_curCollisionPlane);
 
-					if (pPM->m_curCollisionPlane == Plane() || checkCurCollisionPlaneExist == PrimitiveTypes::Constants::c_MaxUInt32)
+					if (controller.m_curCollisionPlane == Plane() || !checkCurCollisionPlaneExist)
 					{
 						// Choose a tangential direction (left/right) that most reduces distance to the goal
-						pPM->m_curCollisionPlane = pPM->m_collisionPlane[i];
+						controller.m_curCollisionPlane = pPM->m_collisionPlane[i];
 						Vector3 vLeft = pPM->m_normalVector.crossProduct(pPM->m_collisionPlane[i].getOutsideN());   // slide direction aligned with plane (left)
 						Vector3 vRight = pPM->m_collisionPlane[i].getOutsideN().crossProduct(pPM->m_normalVector); // slide direction aligned with plane (right)
-						pPM->m_moveDodge = (vTargetToCus - vLeft).lengthSqr() < (vTargetToCus - vRight).lengthSqr() ? vLeft : vRight;
+						controller.m_moveDodge = (vTargetToCus - vLeft).lengthSqr() < (vTargetToCus - vRight).lengthSqr() ? vLeft : vRight;
 					}
 							
-					dir = pPM->m_moveDodge;
+					dir = controller.m_moveDodge;
 
 					// Cache a “retreat + slide” vector: nudge away along the normal, then continue tangentially
-					if (pPM->m_moveAfterBackWard == Vector3() || 
-						(vTargetToCus - dir).lengthSqr() < (vTargetToCus - pPM->m_moveAfterBackWard).lengthSqr())
+					if (controller.m_moveAfterBackWard == Vector3() || 
+						(vTargetToCus - dir).lengthSqr() < (vTargetToCus - controller.m_moveAfterBackWard).lengthSqr())
 					{
-						pPM->m_moveAfterBackWard = dir;
-						pPM->m_moveBackWard = pPM->m_collisionPlane[i].getOutsideN() + dir; // small push off the obstacle, then glide
+						controller.m_moveAfterBackWard = dir;
+						controller.m_moveBackWard = pPM->m_collisionPlane[i].getOutsideN() + dir; // small push off the obstacle, then glide
 					}
 					else
 					{
-						dir = pPM->m_moveAfterBackWard;
+						dir = controller.m_moveAfterBackWard;
 					}
-					pPM->m_backward = true;
+					controller.m_backward = true;
 				}
 				
 			}
 
 			if (pPM->m_collisionCount == 0)  // No contacts: apply a simple gravity step
 			{
-				pPM->m_fallingTime += 0.006f;
-				float velocityOfFalling = -(pPM->m_accelerationOfGravity * pPM->m_fallingTime);
+				controller.m_fallingTime += 0.006f;
+				float velocityOfFalling = -(controller.m_accelerationOfGravity * controller.m_fallingTime);
 				dir = Vector3(0, velocityOfFalling, 0);
 
 				pSN->m_base.setPos(curPos + dir);
 			} 
 			else  // Grounded: move along surface / toward target
 			{
-				pPM->m_fallingTime = 0;
+				controller.m_fallingTime = 0;
 				float dsqr = (m_targetPostion - curPos).lengthSqr();
 
 				bool reached = true;
@@ -166,17 +163,17 @@ void SoldierNPCMovementSM::do_UPDATE(PE::Events::Event *pEvt)
 					static float speed = 1.4f;
 					float allowedDisp = speed * pRealEvt->m_frameTime;
 
-					if (pPM->m_backward)  // In avoidance phase
+					if (controller.m_backward)  // In avoidance phase
 					{
 						if (pPM->m_collisionCount <= 1)  // Only ground remains: finish avoidance and resume normal move
 						{
-							dir = pPM->m_moveAfterBackWard;
-							pPM->m_moveAfterBackWard = Vector3();
-							pPM->m_moveBackWard = Vector3();
-							pPM->m_backward = false;
+							dir = controller.m_moveAfterBackWard;
+							controller.m_moveAfterBackWard = Vector3();
+							controller.m_moveBackWard = Vector3();
+							controller.m_backward = false;
 						}
 						else {
-							dir = pPM->m_moveBackWard;  // Keep performing “back off + slide” while obstacles persist
+							dir = controller.m_moveBackWard;  // Keep performing “back off + slide” while obstacles persist
 						}
 					}
 					else
@@ -206,17 +203,13 @@ void SoldierNPCMovementSM::do_UPDATE(PE::Events::Event *pEvt)
 
 					// Destination reached: notify peer components on the same parent
 					{
-						PE::Handle h("SoldierNPCMovementSM_Event_TARGET_REACHED", sizeof(SoldierNPCMovementSM_Event_TARGET_REACHED));
-						Events::SoldierNPCMovementSM_Event_TARGET_REACHED *pOutEvt = new(h) SoldierNPCMovementSM_Event_TARGET_REACHED();
+						Events::SoldierNPCMovementSM_Event_TARGET_REACHED evt;
 
 						PE::Handle hParent = getFirstParentByType<Component>();
 						if (hParent.isValid())
 						{
-							hParent.getObject<Component>()->handleEvent(pOutEvt);
+							hParent.getObject<Component>()->handleEvent(&evt);
 						}
-
-						// release memory now that event is processed
-						h.release();
 					}
 
 					if (m_state == STANDING)